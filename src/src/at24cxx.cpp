@@ -8,8 +8,13 @@
 // Copyright   : MIT License 2022, John Greenwell
 //----------------------------------------------------------------------------
 
+#ifdef ARDUINO
 #include <Arduino.h>
 #include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
 #include "at24cxx.h"
 
 namespace PeripheralIO {
@@ -23,7 +28,39 @@ AT24CXX::AT24CXX()
   _addr_size(0),
   _mode(0),
   _wp_pin(-1),
-  _wire(nullptr)
+  _ack_poll_us(0),
+  _wire(nullptr),
+  _async_state(ASYNC_IDLE),
+  _async_address(0),
+  _async_vals(nullptr),
+  _async_n(0),
+  _async_sent(0),
+  _async_start(0),
+  _async_callback(nullptr),
+  _async_context(nullptr),
+  _observer(nullptr),
+  _observer_context(nullptr),
+  _compare_mode(COMPARE_OFF),
+  _pages_written(0),
+  _pages_skipped(0),
+  _track_pointer(false),
+  _pointer_valid(false),
+  _pointer(0),
+  _prefetch_on(false),
+  _prefetch(),
+  _prefetch_addr(0),
+  _prefetch_len(0),
+  _last_end(0xFFFFFFFF),
+  _prefetch_hits(0),
+  _prefetch_misses(0),
+  _stats(nullptr),
+  _wear(nullptr),
+  _wear_pages(0),
+  _wear_persist(false),
+  _wear_address(0),
+  _wear_interval_ms(0),
+  _wear_saved_ms(0),
+  _wear_dirty(false)
 { }
 
 /*!
@@ -40,10 +77,13 @@ void AT24CXX::begin(uint32_t chip, uint8_t chip_addr, TwoWire& wire,
     _addr_ov_bits = (uint8_t)((chip & 0xC0000000) >> 30);
     _wire = &wire;
     _wp_pin = wp_pin;
-    if (_wp_pin != -1) {
+    if (_wp_pin != (uint8_t)-1) {
         pinMode(_wp_pin, OUTPUT);
         digitalWrite(_wp_pin, LOW);
     }
+    _pointer_valid = false;
+    _prefetch_len = 0;
+    _last_end = 0xFFFFFFFF; // No previous read to continue
     _mode = 1; // Active mode
 }
 
@@ -57,6 +97,7 @@ bool AT24CXX::isConnected() const {
         _wire->beginTransmission(_chip_addr);
         if (_wire->endTransmission() == 0)
             acknowledged = true;
+        countTransfer(acknowledged);
     }
     return acknowledged;
 }
@@ -79,7 +120,7 @@ bool AT24CXX::write(uint16_t address, uint8_t val) const {
     @param n Number of successive bytes to write
     @return False for failed to write (e.g. invalid memory regions)
 */
-bool AT24CXX::write(uint16_t address, uint8_t vals[], uint8_t n) const {
+bool AT24CXX::write(uint16_t address, const uint8_t vals[], size_t n) const {
     return writeN(address, vals, n);
 }
 
@@ -90,8 +131,25 @@ bool AT24CXX::write(uint16_t address, uint8_t vals[], uint8_t n) const {
     @param n Number of successive chars to write
     @return False for failed to write (e.g. invalid memory regions)
 */
-bool AT24CXX::write(uint16_t address, const char str[], uint8_t n) const {
-    return writeN(address, (uint8_t*)str, n);
+bool AT24CXX::write(uint16_t address, const char str[], size_t n) const {
+    return writeN(address, (const uint8_t*)str, n);
+}
+
+/*!
+    @brief Write n successive bytes followed by a trailer, e.g. a checksum
+    @param address Address to write bytes
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @param trailer Pointer to bytes written after vals, in the same pages
+    @param n_trailer Number of trailer bytes
+    @param hook Function passed each page's share of vals before it is sent
+    @param context Pointer passed to hook
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+bool AT24CXX::write(uint16_t address, const uint8_t vals[], size_t n,
+                    const uint8_t trailer[], uint8_t n_trailer,
+                    AT24CXXChunkHook hook, void* context) const {
+    return writeN(address, vals, n, trailer, n_trailer, hook, context);
 }
 
 /*!
@@ -112,8 +170,8 @@ uint8_t AT24CXX::read(uint16_t address) const {
     @param n Number of successive bytes to read
     @return False for failed to read (e.g. invalid memory regions)
 */
-bool AT24CXX::read(uint16_t address, uint8_t* vals, uint8_t n) const {
-    return readN(address, vals, 1);
+bool AT24CXX::read(uint16_t address, uint8_t* vals, size_t n) const {
+    return readN(address, vals, n);
 }
 
 /*!
@@ -123,15 +181,32 @@ bool AT24CXX::read(uint16_t address, uint8_t* vals, uint8_t n) const {
     @param n Number of successive chars to read
     @return False for failed to read (e.g. invalid memory regions)
 */
-bool AT24CXX::read(uint16_t address, char str[], uint8_t n) const {
+bool AT24CXX::read(uint16_t address, char str[], size_t n) const {
     return readN(address, (uint8_t*)str, n);
 }
 
+/*!
+    @brief Read n successive bytes and a trailer in one sequential read
+    @param address Address to read bytes
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @param trailer Pointer to array the following bytes will be written to
+    @param n_trailer Number of trailer bytes
+    @param hook Function passed each share of vals as it arrives
+    @param context Pointer passed to hook
+    @return False for failed to read (e.g. invalid memory regions)
+*/
+bool AT24CXX::read(uint16_t address, uint8_t vals[], size_t n,
+                   uint8_t trailer[], uint8_t n_trailer,
+                   AT24CXXChunkHook hook, void* context) const {
+    return readN(address, vals, n, trailer, n_trailer, hook, context);
+}
+
 /*!
     @brief Raise WP pin so that write operations may not be applied
 */
 void AT24CXX::setWriteProtect() const {
-    if (_wp_pin != -1) {
+    if (_wp_pin != (uint8_t)-1) {
         digitalWrite(_wp_pin, HIGH);
     }
 }
@@ -140,86 +215,710 @@ void AT24CXX::setWriteProtect() const {
     @brief Release WP pin so that write operations may be applied
 */
 void AT24CXX::clearWriteProtect() const {
-    if (_wp_pin != -1) {
+    if (_wp_pin != (uint8_t)-1) {
         digitalWrite(_wp_pin, LOW);
     }
 }
 
-// Private: Hardware I2C Write Function
-bool AT24CXX::writeN(uint16_t address, uint8_t* vals, uint8_t n) const {
+/*!
+    @brief Detect write cycle completion by ACK polling
+    @param timeout_us Maximum time to poll for each page write cycle
+*/
+void AT24CXX::setAckPolling(uint16_t timeout_us) {
+    _ack_poll_us = timeout_us;
+}
+
+/*!
+    @brief Return to fixed delay for write cycle completion
+*/
+void AT24CXX::clearAckPolling() {
+    _ack_poll_us = 0;
+}
+
+/*!
+    @brief Submit n bytes for non-blocking write to AT24CXX
+    @param address Address to write bytes
+    @param vals Pointer to bytes, must remain valid until completion
+    @param n Number of successive bytes to write
+    @param callback Function called on completion, may be nullptr
+    @param context Pointer passed through to callback
+    @return False for rejected write (e.g. busy or invalid memory regions)
+*/
+bool AT24CXX::writeAsync(uint16_t address, const uint8_t vals[], size_t n,
+                         AT24CXXCallback callback, void* context) {
     bool result = false;
-    if (_mode && ((uint32_t)(address + n) <= _chip_size)) {
-        uint8_t page_size = _page_size;
-        if ((_addr_bytes > 1) && (n > 30))
-            page_size = 16; // AT24C32+ can only write 30 bytes at a time
-        uint8_t j = address % page_size;
-        uint8_t pages_req = (((n + j - 1) / page_size) + 1);
-        uint8_t addr = _chip_addr;
-        uint8_t n_sent = 0;
-        for (uint8_t i = 0; i < pages_req; i++) {
-            if (_addr_ov_bits)
-                addr = ((uint8_t)((_chip_addr & 0xF8) |
-                        (((address + n_sent) & 0x0700) >> 8)));
+    if (_mode && (_async_state == ASYNC_IDLE) &&
+        ((uint32_t)(address + n) <= _chip_size)) {
+        _async_address = address;
+        _async_vals = vals;
+        _async_n = n;
+        _async_sent = 0;
+        _async_callback = callback;
+        _async_context = context;
+        _async_state = ASYNC_PROGRAM;
+        result = true;
+    }
+    return result;
+}
+
+/*!
+    @brief Advance pending non-blocking write by at most one bus transfer
+    @return True while a write remains pending
+*/
+bool AT24CXX::service() {
+    if (_async_state == ASYNC_CYCLE) {
+        uint8_t addr = deviceAddress(_async_address + _async_sent - 1);
+        uint32_t elapsed = (uint32_t)(micros() - _async_start);
+        if (_ack_poll_us) {
             _wire->beginTransmission(addr);
-            if (_addr_bytes > 1)
-                _wire->write((uint8_t)((address + n_sent) >> 8));
-            _wire->write((uint8_t)(address + n_sent));
-            while ((j++ < page_size) && (n_sent < n))
-                _wire->write(vals[n_sent++]);
-            _wire->endTransmission(1);
-            j = 0;
-            delay(EEPROM_WRITE_CYCLE_TIME_MS);
+            bool acknowledged = (_wire->endTransmission() == 0);
+            countTransfer(acknowledged);
+            if (_stats)
+                _stats->ack_polls++;
+            // On timeout, keep polling until the datasheet write cycle time
+            // has also passed, as the fixed delay would have waited
+            if (acknowledged)
+                _async_state = ASYNC_PROGRAM;
+            else if ((elapsed >= _ack_poll_us) &&
+                     (elapsed >= (uint32_t)EEPROM_WRITE_CYCLE_TIME_MS * 1000))
+                finishAsync(false);
+        } else if (elapsed >= (uint32_t)EEPROM_WRITE_CYCLE_TIME_MS * 1000) {
+            _async_state = ASYNC_PROGRAM;
+        }
+    }
+    if (_async_state == ASYNC_PROGRAM) {
+        if (_async_sent < _async_n) {
+            uint16_t at = _async_address + _async_sent;
+            uint8_t len = writeChunk(at, _async_n - _async_sent);
+            if (writePage(at, &_async_vals[_async_sent], len) == len) {
+                _async_sent += len;
+                _async_start = micros();
+                _async_state = ASYNC_CYCLE;
+            } else {
+                finishAsync(false);
+            }
+        } else {
+            finishAsync(true);
+        }
+    }
+    if (_wear_persist && _wear_dirty && (_async_state == ASYNC_IDLE) &&
+        ((uint32_t)(millis() - _wear_saved_ms) >= _wear_interval_ms)) {
+        // A failed save is also retried only after the interval
+        saveWear(_wear_address);
+        _wear_saved_ms = millis();
+    }
+    return (_async_state != ASYNC_IDLE);
+}
+
+/*!
+    @brief Check for pending non-blocking write
+    @return True while a write submitted by writeAsync() is in progress
+*/
+bool AT24CXX::isWriteBusy() const {
+    return (_async_state != ASYNC_IDLE);
+}
+
+/*!
+    @brief Memory size of AT24CXX
+    @return Size in bytes
+*/
+uint32_t AT24CXX::size() const {
+    return _chip_size;
+}
+
+/*!
+    @brief Write page size of AT24CXX
+    @return Page size in bytes
+*/
+uint8_t AT24CXX::pageSize() const {
+    return _page_size;
+}
+
+/*!
+    @brief Register function notified of every page write
+    @param observer Function called with address and data written
+    @param context Pointer passed through to observer
+*/
+void AT24CXX::setWriteObserver(AT24CXXWriteObserver observer, void* context) {
+    _observer = observer;
+    _observer_context = context;
+}
+
+/*!
+    @brief Function notified of every page write
+    @param context Receives the observer's context, may be nullptr
+    @return Registered observer, nullptr if none
+*/
+AT24CXXWriteObserver AT24CXX::writeObserver(void** context) const {
+    if (context)
+        *context = _observer_context;
+    return _observer;
+}
+
+/*!
+    @brief Skip programming of pages whose content is unchanged
+    @param span_only Program only the differing span within each page
+*/
+void AT24CXX::setWriteCompare(bool span_only) {
+    _compare_mode = span_only ? COMPARE_SPAN : COMPARE_PAGE;
+}
+
+/*!
+    @brief Program every page of a write without reading back
+*/
+void AT24CXX::clearWriteCompare() {
+    _compare_mode = COMPARE_OFF;
+}
+
+/*!
+    @brief Count pages programmed by synchronous writes
+    @return Number of page transfers
+*/
+uint32_t AT24CXX::pagesWritten() const {
+    return _pages_written;
+}
+
+/*!
+    @brief Count pages skipped as unchanged by synchronous writes
+    @return Number of pages not programmed
+*/
+uint32_t AT24CXX::pagesSkipped() const {
+    return _pages_skipped;
+}
+
+/*!
+    @brief Reset page write and skip counters
+*/
+void AT24CXX::resetPageCounters() {
+    _pages_written = 0;
+    _pages_skipped = 0;
+}
+
+/*!
+    @brief Track chip address counter to skip redundant address phases
+*/
+void AT24CXX::setAddressTracking() {
+    _track_pointer = true;
+}
+
+/*!
+    @brief Send the word address before every read
+*/
+void AT24CXX::clearAddressTracking() {
+    _track_pointer = false;
+    _pointer_valid = false;
+}
+
+/*!
+    @brief Prefetch following bytes when reads are found to be ascending
+*/
+void AT24CXX::setPrefetch() {
+    _prefetch_on = true;
+}
+
+/*!
+    @brief Read only the bytes requested
+*/
+void AT24CXX::clearPrefetch() {
+    _prefetch_on = false;
+    _prefetch_len = 0;
+}
+
+/*!
+    @brief Count reads served entirely from the prefetch buffer
+    @return Number of hits
+*/
+uint32_t AT24CXX::prefetchHits() const {
+    return _prefetch_hits;
+}
+
+/*!
+    @brief Count reads with prefetch enabled that accessed the chip
+    @return Number of misses
+*/
+uint32_t AT24CXX::prefetchMisses() const {
+    return _prefetch_misses;
+}
+
+/*!
+    @brief Count transfers and time blocking calls
+    @param stats Counters and latency histograms to add to
+*/
+void AT24CXX::setTelemetry(AT24CXXStats* stats) {
+    _stats = stats;
+}
+
+/*!
+    @brief Stop counting, leaving the counts collected so far
+*/
+void AT24CXX::clearTelemetry() {
+    _stats = nullptr;
+}
+
+/*!
+    @brief Reset all counters and histograms of the supplied stats
+*/
+void AT24CXX::resetTelemetry() {
+    if (_stats)
+        memset(_stats, 0, sizeof(*_stats));
+}
+
+/*!
+    @brief Count writes of each page into caller-supplied array
+    @param counts Array of at least size() / pageSize() counters
+    @param n_pages Number of entries in counts
+    @return False if counts is too short
+*/
+bool AT24CXX::setWearTracking(uint32_t counts[], uint16_t n_pages) {
+    bool result = false;
+    if (_mode && (n_pages >= _chip_size / _page_size)) {
+        _wear = counts;
+        _wear_pages = (uint16_t)(_chip_size / _page_size);
+        _wear_dirty = false;
+        result = true;
+    }
+    return result;
+}
+
+/*!
+    @brief Stop counting page writes and saving counts
+*/
+void AT24CXX::clearWearTracking() {
+    _wear = nullptr;
+    _wear_pages = 0;
+    _wear_persist = false;
+}
+
+/*!
+    @brief Writes counted for one page
+    @param page Page number, i.e. address / pageSize()
+    @return Number of writes, zero if not tracked
+*/
+uint32_t AT24CXX::pageWrites(uint16_t page) const {
+    return (page < _wear_pages) ? _wear[page] : 0;
+}
+
+/*!
+    @brief Find the most written pages
+    @param pages Array to receive page numbers, most written first
+    @param n Number of entries in pages
+    @return Number of page numbers filled
+*/
+uint16_t AT24CXX::hottestPages(uint16_t pages[], uint16_t n) const {
+    uint16_t n_found = (n < _wear_pages) ? n : _wear_pages;
+    for (uint16_t i = 0; i < n_found; i++) {
+        // Selection of the next largest count not already listed
+        bool found = false;
+        uint16_t best = 0;
+        for (uint16_t page = 0; page < _wear_pages; page++) {
+            bool listed = false;
+            for (uint16_t j = 0; !listed && (j < i); j++)
+                listed = (pages[j] == page);
+            if (!listed && (!found || (_wear[page] > _wear[best]))) {
+                best = page;
+                found = true;
+            }
         }
+        pages[i] = best;
+    }
+    return n_found;
+}
+
+/*!
+    @brief Write cycles remaining on the most written page
+    @param endurance Rated write cycles per page
+    @return Cycles remaining, zero once endurance is reached
+*/
+uint32_t AT24CXX::remainingLife(uint32_t endurance) const {
+    uint32_t most = 0;
+    for (uint16_t page = 0; page < _wear_pages; page++) {
+        if (_wear[page] > most)
+            most = _wear[page];
+    }
+    return (most < endurance) ? endurance - most : 0;
+}
+
+/*!
+    @brief Size of region needed by saveWear()
+    @return Size in bytes
+*/
+uint32_t AT24CXX::wearRegionSize() const {
+    return WEAR_HEADER_SIZE + (uint32_t)_wear_pages * sizeof(uint32_t);
+}
+
+/*!
+    @brief Save page write counts to a reserved region
+    @param address Start of region of wearRegionSize() bytes
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+bool AT24CXX::saveWear(uint16_t address) const {
+    bool result = false;
+    if (_wear) {
+        uint8_t header[WEAR_HEADER_SIZE] = {
+            (uint8_t)WEAR_MAGIC, (uint8_t)(WEAR_MAGIC >> 8),
+            (uint8_t)_wear_pages, (uint8_t)(_wear_pages >> 8)
+        };
+        result = writeN(address, header, WEAR_HEADER_SIZE) &&
+                 writeN(address + WEAR_HEADER_SIZE, (const uint8_t*)_wear,
+                        (size_t)_wear_pages * sizeof(uint32_t));
+        if (result)
+            _wear_dirty = false;
+    }
+    return result;
+}
+
+/*!
+    @brief Restore page write counts saved by saveWear()
+    @param address Start of region
+    @return False if no counts for this chip were saved at address
+*/
+bool AT24CXX::loadWear(uint16_t address) {
+    bool result = false;
+    uint8_t header[WEAR_HEADER_SIZE];
+    if (_wear && readN(address, header, WEAR_HEADER_SIZE) &&
+        (header[0] == (uint8_t)WEAR_MAGIC) &&
+        (header[1] == (uint8_t)(WEAR_MAGIC >> 8)) &&
+        (header[2] == (uint8_t)_wear_pages) &&
+        (header[3] == (uint8_t)(_wear_pages >> 8))) {
+        result = readN(address + WEAR_HEADER_SIZE, (uint8_t*)_wear,
+                       (size_t)_wear_pages * sizeof(uint32_t));
+    }
+    return result;
+}
+
+/*!
+    @brief Save page write counts periodically from service()
+    @param address Start of region of wearRegionSize() bytes
+    @param interval_ms Minimum time between saves
+*/
+void AT24CXX::setWearPersistence(uint16_t address, uint32_t interval_ms) {
+    _wear_persist = true;
+    _wear_address = address;
+    _wear_interval_ms = interval_ms;
+    _wear_saved_ms = millis();
+}
+
+// Private: Hardware I2C Write Function, n bytes of vals then n_tail of tail
+bool AT24CXX::writeN(uint16_t address, const uint8_t* vals, size_t n,
+                     const uint8_t* tail, uint8_t n_tail,
+                     AT24CXXChunkHook hook, void* context) const {
+    bool result = false;
+    size_t total = n + n_tail;
+    if (_mode && (_async_state == ASYNC_IDLE) &&
+        ((uint32_t)address + total <= _chip_size)) {
+        uint32_t start = _stats ? micros() : 0;
+        size_t n_sent = 0;
         result = true;
+        while (result && (n_sent < total)) {
+            uint16_t at = address + n_sent;
+            uint8_t len = writeChunk(at, total - n_sent);
+            uint8_t lo = 0;
+            uint8_t hi = len;
+            if (hook && (n_sent < n))
+                hook(&vals[n_sent], (n - n_sent < len) ? n - n_sent : len,
+                     context);
+            if (_compare_mode) {
+                // Read back and program only what differs
+                uint8_t current[AT24CXX_MAX_PAGE_SIZE];
+                result = readBus(at, current, len);
+                while ((lo < len) &&
+                       (current[lo] == spanByte(vals, n, tail, n_sent + lo)))
+                    lo++;
+                if (_compare_mode == COMPARE_SPAN) {
+                    while ((hi > lo) &&
+                           (current[hi - 1] ==
+                            spanByte(vals, n, tail, n_sent + hi - 1)))
+                        hi--;
+                } else if (lo < len) {
+                    lo = 0;
+                }
+            }
+            if (result && (lo < hi)) {
+                // The page's bytes may run on from vals into tail
+                size_t from = n_sent + lo;
+                uint8_t n_head = hi - lo;
+                if (from >= n)
+                    n_head = 0;
+                else if (n - from < n_head)
+                    n_head = (uint8_t)(n - from);
+                const uint8_t* head = n_head ? &vals[from] : nullptr;
+                const uint8_t* rest = (n_head < hi - lo) ?
+                                      &tail[from + n_head - n] : nullptr;
+                result = (writePage(at + lo, head, n_head, rest,
+                                    hi - lo - n_head) == hi - lo) &&
+                         waitWriteCycle(deviceAddress(at));
+                if (result)
+                    _pages_written++;
+            } else if (result) {
+                _pages_skipped++;
+            }
+            n_sent += len;
+        }
+        if (_stats)
+            countLatency(_stats->write_latency, (uint32_t)(micros() - start));
     }
     return result;
 }
 
-// Private: Hardware I2C Read Function
-bool AT24CXX::readN(uint16_t address, uint8_t* vals, uint8_t n) const {
+// Private: Length of next write transfer of up to n bytes at address
+uint8_t AT24CXX::writeChunk(uint16_t address, size_t n) const {
+    // Bounded by the page and by the Wire buffer less the word address
+    uint16_t len = _page_size - (address % _page_size);
+    if (len > I2C_WRITE_BUFFER_SIZE - _addr_bytes)
+        len = I2C_WRITE_BUFFER_SIZE - _addr_bytes;
+    if (len > n)
+        len = n;
+    return (uint8_t)len;
+}
+
+// Private: Device address selecting block of memory address
+uint8_t AT24CXX::deviceAddress(uint16_t address) const {
+    uint8_t addr = _chip_addr;
+    if (_addr_ov_bits) {
+        // Block bits replace only as many chip select pins as they need
+        uint8_t block_mask = (uint8_t)((1 << _addr_ov_bits) - 1);
+        addr = (uint8_t)((_chip_addr & ~block_mask) |
+                         ((address >> 8) & block_mask));
+    }
+    return addr;
+}
+
+// Private: Byte i of n bytes of vals followed by tail
+uint8_t AT24CXX::spanByte(const uint8_t* vals, size_t n, const uint8_t* tail,
+                          size_t i) {
+    return (i < n) ? vals[i] : tail[i - n];
+}
+
+// Private: Transfer n bytes of vals then n_tail of tail within one page,
+// returns number of bytes written, zero if the chip did not acknowledge
+// (e.g. absent, busy or WP)
+uint8_t AT24CXX::writePage(uint16_t address, const uint8_t* vals, uint8_t n,
+                           const uint8_t* tail, uint8_t n_tail) const {
+    uint8_t header[2] = { (uint8_t)(address >> 8), (uint8_t)address };
+    _wire->beginTransmission(deviceAddress(address));
+    _wire->write(&header[2 - _addr_bytes], _addr_bytes);
+    uint8_t n_sent = n ? (uint8_t)_wire->write(vals, n) : 0;
+    if (n_tail && (n_sent == n))
+        n_sent += (uint8_t)_wire->write(tail, n_tail);
+    bool acknowledged = (_wire->endTransmission(1) == 0);
+    countTransfer(acknowledged);
+    _pointer_valid = false;
+    _prefetch_len = 0;
+    if (acknowledged) {
+        if (_stats) {
+            _stats->bytes_written += n_sent;
+            _stats->write_cycles++;
+        }
+        if (_wear)
+            countWear(address);
+        if (_observer && n)
+            _observer(address, vals, (n_sent < n) ? n_sent : n,
+                      _observer_context);
+        if (_observer && (n_sent > n))
+            _observer((uint16_t)(address + n), tail, n_sent - n,
+                      _observer_context);
+    } else {
+        n_sent = 0;
+    }
+    return n_sent;
+}
+
+// Private: Read, serving from and refilling the prefetch buffer, or with a
+// tail or hook as one sequential read past it
+bool AT24CXX::readN(uint16_t address, uint8_t* vals, size_t n, uint8_t* tail,
+                    uint8_t n_tail, AT24CXXChunkHook hook,
+                    void* context) const {
     bool result = false;
-    if (_mode && ((uint32_t)(address + n) <= _chip_size)) {
-        uint8_t addr = _chip_addr;
-        if (_addr_ov_bits)
-            addr = ((uint8_t)((_chip_addr & 0xF8) |
-                    (((address + 0) & 0x0700) >> 8)));
+    if (_mode && (_async_state == ASYNC_IDLE) &&
+        ((uint32_t)address + n + n_tail <= _chip_size)) {
+        uint32_t start = _stats ? micros() : 0;
+        size_t done = 0;
+        result = true;
+        if (n_tail || hook) {
+            // Bytes split between two buffers or watched by the caller
+            // come straight from the bus, leaving prefetch as it is
+            done = n;
+            result = readBus(address, vals, n, tail, n_tail, hook, context);
+        } else if (_prefetch_len && (address >= _prefetch_addr) &&
+                   (address < _prefetch_addr + _prefetch_len)) {
+            done = _prefetch_addr + _prefetch_len - address;
+            if (done > n)
+                done = n;
+            memcpy(vals, &_prefetch[address - _prefetch_addr], done);
+        }
+        if (done < n) {
+            result = readBus(address + done, &vals[done], n - done);
+            if (_prefetch_on) {
+                _prefetch_misses++;
+                _prefetch_len = 0;
+                // Ascending access: fetch the following bytes in advance
+                uint32_t end = (uint32_t)address + n;
+                if (result && (address == _last_end) && (end < _chip_size)) {
+                    uint32_t len = _chip_size - end;
+                    if (len > PREFETCH_SIZE)
+                        len = PREFETCH_SIZE;
+                    if (readBus((uint16_t)end, _prefetch, len)) {
+                        _prefetch_addr = end;
+                        _prefetch_len = (uint8_t)len;
+                    }
+                }
+            }
+        } else if (_prefetch_on && done && !n_tail && !hook) {
+            _prefetch_hits++;
+        }
+        _last_end = (uint32_t)address + n + n_tail;
+        if (_stats)
+            countLatency(_stats->read_latency, (uint32_t)(micros() - start));
+    }
+    return result;
+}
+
+// Private: Hardware I2C Read Function, one transfer sequence per block, of
+// n bytes into vals then n_tail into tail
+bool AT24CXX::readBus(uint16_t address, uint8_t* vals, size_t n,
+                      uint8_t* tail, uint8_t n_tail, AT24CXXChunkHook hook,
+                      void* context) const {
+    bool result = true;
+    size_t total = n + n_tail;
+    size_t done = 0;
+    while (result && (done < total)) {
+        uint16_t at = (uint16_t)(address + done);
+        size_t len = total - done;
+        // Block-select bits are part of the device address, so a read
+        // crossing into the next 256-byte block is addressed afresh
+        if (_addr_ov_bits && (len > 256u - (at & 0xFF)))
+            len = 256u - (at & 0xFF);
+        size_t n_head = (done < n) ? n - done : 0;
+        if (n_head > len)
+            n_head = len;
+        result = readBlock(at, n_head ? &vals[done] : nullptr, n_head,
+                           (n_head < len) ? &tail[done + n_head - n] : nullptr,
+                           len - n_head, hook, context);
+        done += len;
+    }
+    return result;
+}
+
+// Private: Read n bytes into vals then n_tail into tail within one block,
+// passing each transfer's share of vals to hook
+bool AT24CXX::readBlock(uint16_t address, uint8_t* vals, size_t n,
+                        uint8_t* tail, size_t n_tail, AT24CXXChunkHook hook,
+                        void* context) const {
+    uint8_t addr = deviceAddress(address);
+    bool result = true;
+    // Current address read only within a block, not across its start
+    if (!_track_pointer || !_pointer_valid || (_pointer != address) ||
+        (_addr_ov_bits && !(address & 0xFF))) {
+        // Dummy write sets the address, else current address read
         _wire->beginTransmission(addr);
-        if (_addr_bytes > 1) 
+        if (_addr_bytes > 1)
             _wire->write((uint8_t)((address) >> 8));
         _wire->write((uint8_t)(address));
-        _wire->endTransmission(0);
-        uint8_t bytes_read = 0;
-        uint8_t bytes_per_cycle = 0;
-        while (bytes_read < n) {
-            if (I2C_READ_BUFFER_SIZE < n - bytes_read)
-                bytes_per_cycle = I2C_READ_BUFFER_SIZE;
-            else
-                bytes_per_cycle = n - bytes_read;
-            _wire->requestFrom(addr, bytes_per_cycle);
-            while (_wire->available())
-                vals[bytes_read++] = _wire->read();
-            //(this->*_i2cEndTransmission)(1); // Final stop not necessary
-        }
-        result = true;
+        result = (_wire->endTransmission(0) == 0);
+        countTransfer(result);
     }
+    size_t total = n + n_tail;
+    size_t bytes_read = 0;
+    uint8_t bytes_per_cycle = 0;
+    while (result && (bytes_read < total)) {
+        size_t first = bytes_read;
+        if (I2C_READ_BUFFER_SIZE < total - bytes_read)
+            bytes_per_cycle = I2C_READ_BUFFER_SIZE;
+        else
+            bytes_per_cycle = (uint8_t)(total - bytes_read);
+        result = (_wire->requestFrom(addr, bytes_per_cycle) != 0);
+        countTransfer(result);
+        while (_wire->available() && (bytes_read < n))
+            vals[bytes_read++] = _wire->read();
+        while (_wire->available())
+            tail[bytes_read++ - n] = _wire->read();
+        if (hook && (first < n) && (bytes_read > first))
+            hook(&vals[first], ((bytes_read < n) ? bytes_read : n) - first,
+                 context);
+        //(this->*_i2cEndTransmission)(1); // Final stop not necessary
+    }
+    if (_stats)
+        _stats->bytes_read += bytes_read;
+    // Chip address counter rolls over at the end of memory
+    _pointer = (uint32_t)(address + bytes_read) % _chip_size;
+    _pointer_valid = result;
     return result;
 }
 
-// Chip Selection (word size | page size | addr bytes | addr overflow bits)
-const uint32_t AT24C01 = 128 | (8 << 20) | (1 << 28) | (0 << 30);
-const uint32_t AT24C02 = 256 | (8 << 20) | (1 << 28) | (0 << 30);
-const uint32_t AT24C04 = 512 | (16 << 20) | (1 << 28) | (1 << 30);
-const uint32_t AT24C08 = 1024 | (16 << 20) | (1 << 28) | (2 << 30);
-const uint32_t AT24C16 = 2048 | (16 << 20) | (1 << 28) | (3 << 30);
-const uint32_t AT24C32 = 4096 | (32 << 20) | (2 << 28) | (0 << 30);
-const uint32_t AT24C64 = 8192 | (32 << 20) | (2 << 28) | (0 << 30);
-const uint32_t AT24C128 = 16384 | (64 << 20) | (2 << 28) | (0 << 30);
-const uint32_t AT24C256 = 32768 | (64 << 20) | (2 << 28) | (0 << 30);
-const uint32_t AT24C512 = 65536 | (128 << 20) | (2 << 28) | (0 << 30);
-
-// Base Address and I2C Defines
-const uint8_t AT24CXX_ADDR = 0x50; // 7-bit addr
-const uint8_t I2C_READ_BUFFER_SIZE = 32; // Maximum held in Wire buffer
-const uint8_t EEPROM_WRITE_CYCLE_TIME_MS = 5; // datasheet: 5ms max
+// Private: Conclude non-blocking write and notify caller
+void AT24CXX::finishAsync(bool success) {
+    _async_state = ASYNC_IDLE;
+    if (_async_callback)
+        _async_callback(success, _async_context);
+}
+
+// Private: Count one transfer and whether it was acknowledged
+void AT24CXX::countTransfer(bool acknowledged) const {
+    if (_stats) {
+        _stats->transactions++;
+        if (!acknowledged)
+            _stats->nacks++;
+    }
+}
+
+// Private: Add blocking call duration to total and histogram
+void AT24CXX::countLatency(uint32_t* histogram, uint32_t elapsed_us) const {
+    uint8_t bucket = 0;
+    uint32_t limit = 64;
+    while ((bucket < AT24CXX_LATENCY_BUCKETS - 1) && (elapsed_us >= limit)) {
+        limit <<= 1;
+        bucket++;
+    }
+    histogram[bucket]++;
+    _stats->blocked_us += elapsed_us;
+}
+
+// Private: Count write cycle of page containing address
+void AT24CXX::countWear(uint16_t address) const {
+    _wear[address / _page_size]++;
+    // Saving the counts wears the reserved region, but is not a change
+    // that requires saving again
+    if (!_wear_persist || (address < _wear_address) ||
+        (address >= _wear_address + wearRegionSize()))
+        _wear_dirty = true;
+}
+
+// Private: Wait for completion of page write cycle
+bool AT24CXX::waitWriteCycle(uint8_t addr) const {
+    bool acknowledged = false;
+    if (_ack_poll_us) {
+        // Chip NACKs its address until the internal write cycle is finished
+        uint32_t start = micros();
+        do {
+            _wire->beginTransmission(addr);
+            acknowledged = (_wire->endTransmission() == 0);
+            countTransfer(acknowledged);
+            if (_stats)
+                _stats->ack_polls++;
+        } while (!acknowledged &&
+                 ((uint32_t)(micros() - start) < _ack_poll_us));
+        // Timed out: fall back to the fixed delay, then poll once more
+        uint32_t elapsed = (uint32_t)(micros() - start);
+        uint32_t cycle_us = (uint32_t)EEPROM_WRITE_CYCLE_TIME_MS * 1000;
+        if (!acknowledged) {
+            if (elapsed < cycle_us)
+                delayMicroseconds(cycle_us - elapsed);
+            _wire->beginTransmission(addr);
+            acknowledged = (_wire->endTransmission() == 0);
+            countTransfer(acknowledged);
+            if (_stats)
+                _stats->ack_polls++;
+        }
+    } else {
+        delay(EEPROM_WRITE_CYCLE_TIME_MS);
+        acknowledged = true;
+    }
+    return acknowledged;
+}
+
+// I2C Defines
+const uint16_t I2C_WRITE_BUFFER_SIZE = AT24CXX_BUFFER_LENGTH;
+const uint8_t I2C_READ_BUFFER_SIZE = (I2C_WRITE_BUFFER_SIZE < 255) ?
+                                     I2C_WRITE_BUFFER_SIZE : 255;
 
 }
@@ -6,10 +6,11 @@
 //               Though the AT24CXX family of EEPROM chips are internally
 //               organized according to varied page sizes, use of this class
 //               abstracts away this arrangement so that extended strings and
-//               arrays of arbitrary length (up to 255) may be written to any
-//               random address within the memory. Attempts to overwrite the
-//               end boundary of the chip's memory space will be ignored and
-//               the write()/read() method will return false.
+//               arrays of arbitrary length, up to the whole chip, may be
+//               written to or read from any random address within the
+//               memory. Attempts to overwrite the end boundary of the chip's
+//               memory space will be ignored and the write()/read() method
+//               will return false.
 //
 //               Calls to any operational methods will perform no action if
 //               an initial call to begin() has not yet been performed.
@@ -18,29 +19,115 @@
 //               methods setWriteProtect() and clearWriteProtect() will only
 //               execute properly if wp_pin was included at call to begin().
 //
+//               Write cycle completion defaults to a fixed datasheet delay
+//               after each page. With setAckPolling(), the chip is instead
+//               addressed repeatedly until it acknowledges, so that each
+//               page costs only the chip's actual write cycle time.
+//
+//               Writes may also be submitted without blocking through
+//               writeAsync(). Each call to service(), e.g. from loop(),
+//               then performs at most one page transfer or completion poll,
+//               so the caller continues working during each write cycle.
+//               Synchronous write()/read() calls return false while an
+//               asynchronous write is pending.
+//
+//               Each page is written in as few transfers as the TwoWire
+//               transmit buffer allows, found from the Wire library's
+//               buffer length macro or overridden by build flag
+//               AT24CXX_WIRE_BUFFER_SIZE for enlarged buffers.
+//
+//               With setAddressTracking(), the chip's internal address
+//               counter is tracked, so that a read continuing where the
+//               previous read stopped is issued as a current address read
+//               without the word address phase. Tracking is off by default,
+//               as a chip reset or another driver instance or bus master
+//               moving the counter would go undetected, and later reads
+//               would silently return data from the wrong address.
+//
+//               On the AT24C04/08/16, whose block-select bits are part of
+//               the device address, a read crossing a 256-byte block is
+//               split at the boundary so that each block is addressed with
+//               its own device address and read as one sequential read.
+//
+//               With setPrefetch(), a read that begins where the previous
+//               read ended is extended by PREFETCH_SIZE bytes held in RAM,
+//               so that structures read field by field cost a few bus
+//               transactions rather than one per field. Prefetched bytes are
+//               not refreshed when another instance or bus master writes to
+//               the chip, so prefetch suits a chip with a single writer.
+//
+//               With setWriteCompare(), synchronous writes first read back
+//               each page and skip programming it if unchanged, trading a
+//               short read for a write cycle and its wear.
+//
+//               With setTelemetry(), the instance counts its bus traffic,
+//               write cycles, NACKs and ACK polls, and the time spent in
+//               blocking read()/write() calls with a latency histogram for
+//               each, into a caller-supplied AT24CXXStats. Instances without
+//               telemetry carry only a null pointer. Comparing copies of the
+//               counts before and after a call site attributes the cost to
+//               it.
+//
+//               With setWearTracking(), every page write, synchronous or
+//               not, increments a per-page counter in a caller-supplied
+//               array, which may be saved to and restored from a reserved
+//               region of the chip, periodically from service() if set by
+//               setWearPersistence(). hottestPages() and remainingLife()
+//               report the most written pages against the rated endurance.
+//
 // Platform    : Multiple
 // Language    : C++
 // Framework   : Arduino
 // Copyright   : MIT License 2022, John Greenwell
 // Requires    : External Libraries : N/A
-//               Custom Libraries   : N/A
+//               Custom Libraries   : at24cxx_chips.h
 //----------------------------------------------------------------------------
 #ifndef AT24CXX_H
 #define AT24CXX_H
 
+// Wire transmit buffer length, from build flag or the Wire library
+#if defined(AT24CXX_WIRE_BUFFER_SIZE)
+#define AT24CXX_BUFFER_LENGTH AT24CXX_WIRE_BUFFER_SIZE
+#elif defined(I2C_BUFFER_LENGTH)
+#define AT24CXX_BUFFER_LENGTH I2C_BUFFER_LENGTH // ESP32
+#elif defined(BUFFER_LENGTH)
+#define AT24CXX_BUFFER_LENGTH BUFFER_LENGTH // AVR
+#else
+#define AT24CXX_BUFFER_LENGTH 32
+#endif
+
+#include "at24cxx_chips.h"
+
 namespace PeripheralIO {
 
-// Chip Selection
-extern const uint32_t AT24C01; // Not tested
-extern const uint32_t AT24C02;
-extern const uint32_t AT24C04; // Not tested
-extern const uint32_t AT24C08;
-extern const uint32_t AT24C16;
-extern const uint32_t AT24C32;
-extern const uint32_t AT24C64;
-extern const uint32_t AT24C128;
-extern const uint32_t AT24C256;
-extern const uint32_t AT24C512;
+typedef void (*AT24CXXCallback)(bool success, void* context);
+// Completion callback for non-blocking writes
+
+typedef void (*AT24CXXWriteObserver)(uint16_t address, const uint8_t* vals,
+                                     uint16_t n, void* context);
+// Notification of bytes transferred to the chip by a page write
+
+typedef void (*AT24CXXChunkHook)(const uint8_t* vals, size_t n,
+                                 void* context);
+// Notification of each transfer's share of a record, e.g. to feed a CRC
+
+constexpr uint32_t AT24CXX_ENDURANCE = 1000000;
+// Rated write cycles per page
+
+constexpr uint8_t AT24CXX_LATENCY_BUCKETS = 12;
+// Bucket i counts calls shorter than (64 << i) us, the last all others
+
+struct AT24CXXStats {
+    uint32_t transactions;     // I2C transfers addressed to the chip
+    uint32_t bytes_written;    // Data bytes sent, excluding word address
+    uint32_t bytes_read;       // Data bytes received
+    uint32_t write_cycles;     // Page writes issued
+    uint32_t nacks;            // Transfers not acknowledged
+    uint32_t ack_polls;        // Polls for write cycle completion
+    uint64_t blocked_us;       // Time spent in blocking read() and write()
+    uint32_t read_latency[AT24CXX_LATENCY_BUCKETS];
+    uint32_t write_latency[AT24CXX_LATENCY_BUCKETS];
+};
 
 class AT24CXX {
 public:
@@ -62,26 +149,42 @@ public:
     // Sets iterator to intended address value and proceeds
     // Returns false for attempt to write to invalid memory regions
 
-    bool write(uint16_t address, uint8_t vals[], uint8_t n) const;
+    bool write(uint16_t address, const uint8_t vals[], size_t n) const;
     // Write n successive values to address
     // Returns false for attempt to write to invalid memory regions
 
-    bool write(uint16_t address, const char str[], uint8_t n) const;
+    bool write(uint16_t address, const char str[], size_t n) const;
     // Write string of length n to address
     // Returns false for attempt to write to invalid memory regions
 
+    bool write(uint16_t address, const uint8_t vals[], size_t n,
+               const uint8_t trailer[], uint8_t n_trailer,
+               AT24CXXChunkHook hook=nullptr, void* context=nullptr) const;
+    // Write n values followed by n_trailer bytes of trailer, sharing pages
+    // Passes each page's share of vals to hook before it is sent, so hook
+    // may complete trailer once all n values have passed
+    // Returns false for attempt to write to invalid memory regions
+
     uint8_t read(uint16_t address) const;
     // Read value from specific EEPROM address
     // Returns false for attempt to read from invalid memory regions
 
-    bool read(uint16_t address, uint8_t vals[], uint8_t n) const;
+    bool read(uint16_t address, uint8_t vals[], size_t n) const;
     // Read n values to location of pointer vals starting at address
     // Returns false for attempt to read from invalid memory regions
 
-    bool read(uint16_t address, char str[], uint8_t n) const;
+    bool read(uint16_t address, char str[], size_t n) const;
     // Read n chars to string str starting at address
     // Returns false for attempt to read from invalid memory regions
 
+    bool read(uint16_t address, uint8_t vals[], size_t n, uint8_t trailer[],
+              uint8_t n_trailer, AT24CXXChunkHook hook=nullptr,
+              void* context=nullptr) const;
+    // Read n values and the n_trailer bytes after them into trailer in one
+    // sequential read, bypassing prefetch
+    // Passes each share of vals to hook as it arrives from the bus
+    // Returns false for attempt to read from invalid memory regions
+
     void setWriteProtect() const;
     // Raise WP pin so that write operations may not be applied
     // Requires wp_pin inclusion at call to begin()
@@ -90,9 +193,152 @@ public:
     // Release WP pin so that write operations may be applied
     // Requires wp_pin inclusion at call to begin()
 
+    void setAckPolling(uint16_t timeout_us=10000);
+    // Detect write cycle completion by ACK polling instead of fixed delay
+    // Parameter timeout_us bounds polling per page; on expiry, the rest of
+    // EEPROM_WRITE_CYCLE_TIME_MS is waited out and the chip polled once
+    // more, and only if it still does not respond does write() fail
+
+    void clearAckPolling();
+    // Return to fixed EEPROM_WRITE_CYCLE_TIME_MS delay after each page
+
+    bool writeAsync(uint16_t address, const uint8_t vals[], size_t n,
+                    AT24CXXCallback callback=nullptr, void* context=nullptr);
+    // Submit n successive values for non-blocking write to address
+    // Buffer vals must remain valid until the write completes
+    // Returns false if a write is already pending or for invalid regions
+
+    bool service();
+    // Advance a pending non-blocking write; call repeatedly from loop()
+    // Returns true while the write remains pending
+
+    bool isWriteBusy() const;
+    // Returns true while a non-blocking write is pending
+
+    uint32_t size() const;
+    // Returns memory size of the chip in bytes, zero before begin()
+
+    uint8_t pageSize() const;
+    // Returns write page size of the chip in bytes, zero before begin()
+
+    void setWriteObserver(AT24CXXWriteObserver observer,
+                          void* context=nullptr);
+    // Register function called with the data of every page write, e.g.
+    // to keep a cache coherent; nullptr removes the observer
+    // Only acknowledged page writes are reported
+
+    AT24CXXWriteObserver writeObserver(void** context=nullptr) const;
+    // Returns the registered observer, and its context where requested,
+    // so that a layer registering itself may chain to the previous one
+
+    void setWriteCompare(bool span_only=false);
+    // Read back each page before writing and skip it if unchanged
+    // Parameter span_only limits programming to the differing bytes
+
+    void clearWriteCompare();
+    // Program every page of a write without reading back
+
+    uint32_t pagesWritten() const;
+    // Returns number of pages programmed by write()
+
+    uint32_t pagesSkipped() const;
+    // Returns number of pages skipped as unchanged by write()
+
+    void resetPageCounters();
+    // Reset counts of pages written and skipped
+
+    void setAddressTracking();
+    // Use current address reads where a read continues the last
+    // Only safe while no reset, other instance or bus master moves the
+    // chip's address counter, which would go undetected
+
+    void clearAddressTracking();
+    // Send the word address before every read (default)
+
+    void setPrefetch();
+    // Read ahead into RAM once successive reads are found to be ascending
+    // Prefetched bytes go stale if another instance or bus master writes
+    // the chip; writes through this instance discard them
+
+    void clearPrefetch();
+    // Read only the bytes requested (default)
+
+    uint32_t prefetchHits() const;
+    // Returns number of reads served entirely from prefetched bytes
+
+    uint32_t prefetchMisses() const;
+    // Returns number of reads with prefetch enabled that used the bus
+
+    void setTelemetry(AT24CXXStats* stats);
+    // Count transfers and time blocking calls into stats, which must
+    // remain valid while set; counts add to those already held
+
+    void clearTelemetry();
+    // Stop counting (default); counts are left in the supplied stats
+
+    void resetTelemetry();
+    // Reset all counters and histograms of the supplied stats to zero
+
+    bool setWearTracking(uint32_t counts[], uint16_t n_pages);
+    // Count page writes into counts, which must hold size() / pageSize()
+    // entries and is not cleared, so that it may be preloaded
+    // Returns false if counts is too short
+
+    void clearWearTracking();
+    // Stop counting page writes and saving counts
+
+    uint32_t pageWrites(uint16_t page) const;
+    // Returns writes counted for page number page (address / pageSize())
+
+    uint16_t hottestPages(uint16_t pages[], uint16_t n) const;
+    // Fill pages with up to n page numbers, most written first
+    // Returns number of pages filled
+
+    uint32_t remainingLife(uint32_t endurance=AT24CXX_ENDURANCE) const;
+    // Returns write cycles left on the most written page
+
+    uint32_t wearRegionSize() const;
+    // Returns bytes needed to save the counts
+
+    bool saveWear(uint16_t address) const;
+    // Write counts to the reserved region at address
+
+    bool loadWear(uint16_t address);
+    // Read counts saved at address, returns false if none were saved
+
+    void setWearPersistence(uint16_t address, uint32_t interval_ms);
+    // Save counts to address from service() at most every interval_ms
+    // while changed; writes to the region itself do not trigger a save
+
+    static const uint8_t PREFETCH_SIZE = 32;
+
 private:
-    bool writeN(uint16_t, uint8_t*, uint8_t) const;
-    bool readN(uint16_t, uint8_t*, uint8_t) const;
+    enum AsyncState : uint8_t { ASYNC_IDLE, ASYNC_PROGRAM, ASYNC_CYCLE };
+    enum CompareMode : uint8_t { COMPARE_OFF, COMPARE_PAGE, COMPARE_SPAN };
+
+    static const uint8_t WEAR_HEADER_SIZE = 4;
+    static const uint16_t WEAR_MAGIC = 0x5745; // Marks saved wear counts
+
+    bool writeN(uint16_t, const uint8_t*, size_t, const uint8_t* = nullptr,
+                uint8_t = 0, AT24CXXChunkHook = nullptr,
+                void* = nullptr) const;
+    bool readN(uint16_t, uint8_t*, size_t, uint8_t* = nullptr, uint8_t = 0,
+               AT24CXXChunkHook = nullptr, void* = nullptr) const;
+    bool readBus(uint16_t, uint8_t*, size_t, uint8_t* = nullptr,
+                 uint8_t = 0, AT24CXXChunkHook = nullptr,
+                 void* = nullptr) const;
+    bool readBlock(uint16_t, uint8_t*, size_t, uint8_t*, size_t,
+                   AT24CXXChunkHook, void*) const;
+    uint8_t writeChunk(uint16_t, size_t) const;
+    uint8_t deviceAddress(uint16_t) const;
+    uint8_t writePage(uint16_t, const uint8_t*, uint8_t,
+                      const uint8_t* = nullptr, uint8_t = 0) const;
+    static uint8_t spanByte(const uint8_t*, size_t, const uint8_t*, size_t);
+    bool waitWriteCycle(uint8_t) const;
+    void finishAsync(bool);
+    void countTransfer(bool) const;
+    void countLatency(uint32_t*, uint32_t) const;
+    void countWear(uint16_t) const;
 
     uint8_t _chip_addr;
     uint32_t _chip_size;
@@ -102,15 +348,46 @@ private:
     uint8_t _addr_size;
     uint8_t _mode;
     uint8_t _wp_pin;
+    uint16_t _ack_poll_us;
     TwoWire* _wire;
 
+    AsyncState _async_state;
+    uint16_t _async_address;
+    const uint8_t* _async_vals;
+    size_t _async_n;
+    size_t _async_sent;
+    uint32_t _async_start;
+    AT24CXXCallback _async_callback;
+    void* _async_context;
+    AT24CXXWriteObserver _observer;
+    void* _observer_context;
+    CompareMode _compare_mode;
+    mutable uint32_t _pages_written;
+    mutable uint32_t _pages_skipped;
+    bool _track_pointer;
+    mutable bool _pointer_valid;
+    mutable uint32_t _pointer;
+    bool _prefetch_on;
+    mutable uint8_t _prefetch[PREFETCH_SIZE];
+    mutable uint32_t _prefetch_addr;
+    mutable uint8_t _prefetch_len;
+    mutable uint32_t _last_end;
+    mutable uint32_t _prefetch_hits;
+    mutable uint32_t _prefetch_misses;
+    AT24CXXStats* _stats;
+    uint32_t* _wear;
+    uint16_t _wear_pages;
+    bool _wear_persist;
+    uint16_t _wear_address;
+    uint32_t _wear_interval_ms;
+    uint32_t _wear_saved_ms;
+    mutable bool _wear_dirty;
 
 };
 
-// Base Address and I2C Defines
-extern const uint8_t AT24CXX_ADDR; // 7-bit addr
+// I2C Defines
+extern const uint16_t I2C_WRITE_BUFFER_SIZE; // Wire transmit buffer
 extern const uint8_t I2C_READ_BUFFER_SIZE; // Maximum held in Wire buffer
-extern const uint8_t EEPROM_WRITE_CYCLE_TIME_MS; // datasheet: 5ms max
 
 }
 
@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_array.cpp
+// Purpose     : AT24CXX EEPROM Striped Volume Class
+// Description : This source file accompanies header file at24cxx_array.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include "at24cxx_array.h"
+
+namespace PeripheralIO {
+
+AT24CXXArray::AT24CXXArray()
+: _devices(),
+  _n_devices(0),
+  _page_size(0)
+{ }
+
+/*!
+    @brief Append chip to the volume
+    @param device Chip initialized with begin()
+    @return False for full volume or chip of differing type
+*/
+bool AT24CXXArray::add(AT24CXX& device) {
+    bool result = false;
+    if ((_n_devices < MAX_DEVICES) && device.pageSize() &&
+        (!_n_devices || ((device.size() == _devices[0]->size()) &&
+                         (device.pageSize() == _page_size)))) {
+        _devices[_n_devices++] = &device;
+        _page_size = device.pageSize();
+        result = true;
+    }
+    return result;
+}
+
+/*!
+    @brief Size of the volume
+    @return Size in bytes
+*/
+uint32_t AT24CXXArray::size() const {
+    uint32_t total = 0;
+    if (_n_devices)
+        total = _devices[0]->size() * _n_devices;
+    return total;
+}
+
+/*!
+    @brief Write n bytes to volume from vals
+    @param address Volume address to write bytes
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+bool AT24CXXArray::write(uint32_t address, const uint8_t vals[], uint32_t n) {
+    bool result = false;
+    uint32_t end = address + n;
+    if (_n_devices && (end <= size())) {
+        // Each chip works through its own stripes, one page at a time
+        uint32_t cursor[MAX_DEVICES];
+        for (uint8_t d = 0; d < _n_devices; d++)
+            cursor[d] = end;
+        uint32_t stripe = address;
+        for (uint8_t i = 0; (i < _n_devices) && (stripe < end); i++) {
+            cursor[deviceOf(stripe)] = stripe;
+            stripe = (stripe - (stripe % _page_size)) + _page_size;
+        }
+        result = true;
+        bool pending = true;
+        while (pending) {
+            pending = false;
+            for (uint8_t d = 0; d < _n_devices; d++) {
+                AT24CXX* device = _devices[d];
+                if (!device->isWriteBusy() && result && (cursor[d] < end)) {
+                    size_t len = _page_size - (cursor[d] % _page_size);
+                    if (len > end - cursor[d])
+                        len = end - cursor[d];
+                    result = device->writeAsync(deviceAddress(cursor[d]),
+                                                &vals[cursor[d] - address],
+                                                len, onWriteDone, &result);
+                    cursor[d] = nextStripe(cursor[d]);
+                }
+                // Idle chips with stripes left still hold the loop open
+                if (device->service() || (result && (cursor[d] < end)))
+                    pending = true;
+            }
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Read n bytes from volume to vals
+    @param address Volume address to read bytes
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for failed to read (e.g. invalid memory regions)
+*/
+bool AT24CXXArray::read(uint32_t address, uint8_t vals[], uint32_t n) const {
+    bool result = false;
+    uint32_t end = address + n;
+    if (_n_devices && (end <= size())) {
+        result = true;
+        uint32_t pos = address;
+        while (result && (pos < end)) {
+            size_t len = _page_size - (pos % _page_size);
+            if (len > end - pos)
+                len = end - pos;
+            result = _devices[deviceOf(pos)]->read(deviceAddress(pos),
+                                                   &vals[pos - address], len);
+            pos += len;
+        }
+    }
+    return result;
+}
+
+// Private: Chip holding volume address
+uint8_t AT24CXXArray::deviceOf(uint32_t address) const {
+    return (uint8_t)((address / _page_size) % _n_devices);
+}
+
+// Private: Chip memory address of volume address
+uint16_t AT24CXXArray::deviceAddress(uint32_t address) const {
+    uint32_t stripe = address / _page_size;
+    return (uint16_t)(((stripe / _n_devices) * _page_size) +
+                      (address % _page_size));
+}
+
+// Private: Start of the next stripe on the same chip
+uint32_t AT24CXXArray::nextStripe(uint32_t address) const {
+    return (address - (address % _page_size)) +
+           ((uint32_t)_page_size * _n_devices);
+}
+
+// Private: Completion callback recording failure of any chip write
+void AT24CXXArray::onWriteDone(bool success, void* context) {
+    if (!success)
+        *(bool*)context = false;
+}
+
+}
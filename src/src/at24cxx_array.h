@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_array.h
+// Purpose     : AT24CXX EEPROM Striped Volume Class
+// Description :
+//               This class presents up to eight AT24CXX chips of the same
+//               type as one linear address space. Memory is striped across
+//               the chips in units of one write page, so that successive
+//               pages of the volume lie on successive chips. A write is
+//               split at page boundaries and dispatched through each chip's
+//               non-blocking write engine, so that the write cycles of all
+//               chips overlap.
+//
+//               Chips must have been initialized with begin() before they
+//               are added, and must not have non-blocking writes of their
+//               own pending while the volume is in use.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_ARRAY_H
+#define AT24CXX_ARRAY_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXArray {
+public:
+    AT24CXXArray();
+
+    bool add(AT24CXX& device);
+    // Append chip to the volume, e.g. in order of chip_addr
+    // Returns false when full or for a chip of differing type
+
+    uint32_t size() const;
+    // Returns total size of the volume in bytes
+
+    bool write(uint32_t address, const uint8_t vals[], uint32_t n);
+    // Write n successive values to volume address
+    // Returns false for invalid memory regions or failed write
+
+    bool read(uint32_t address, uint8_t vals[], uint32_t n) const;
+    // Read n successive values from volume address
+    // Returns false for invalid memory regions or failed read
+
+    static const uint8_t MAX_DEVICES = 8;
+
+private:
+    uint8_t deviceOf(uint32_t) const;
+    uint16_t deviceAddress(uint32_t) const;
+    uint32_t nextStripe(uint32_t) const;
+
+    static void onWriteDone(bool, void*);
+
+    AT24CXX* _devices[MAX_DEVICES];
+    uint8_t _n_devices;
+    uint8_t _page_size;
+};
+
+}
+
+#endif
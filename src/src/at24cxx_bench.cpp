@@ -0,0 +1,540 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_bench.cpp
+// Purpose     : AT24CXX EEPROM Throughput and Latency Benchmark
+// Description :
+//               This host program measures the AT24CXX driver against the
+//               simulator of at24cxx_sim.h for every chip type from AT24C01
+//               to AT24C512 at bus clocks of 100 kHz, 400 kHz and 1 MHz.
+//               For reads and writes it times single bytes at scattered
+//               addresses, page-aligned pages, pages straddling a page
+//               boundary, and one whole-chip transfer, and reports the
+//               simulated throughput and per-operation latency.
+//
+//               Writes use ACK polling, so each write includes its final
+//               write cycle. Output is CSV, or JSON with argument --json,
+//               for comparison between releases. Each row counts the
+//               operations that failed or read back wrong data, which are
+//               excluded from the timings, and the program exits with
+//               status 1 if any failed.
+//
+//               With argument --scenarios, it instead runs the multi-chip
+//               and mode comparisons quoted for the library's layers: eight
+//               chips written serially and through AT24CXXScheduler, a
+//               striped AT24CXXArray against a single chip, an
+//               AT24CXXMirror against writing both chips in turn, a one-byte
+//               change with and without setWriteCompare(), and consecutive
+//               record reads with and without setAddressTracking().
+//
+//               With argument --crc, it instead times the CRC-32 kernels of
+//               at24cxx_crc.h on the host CPU over records of several sizes
+//               and reports their throughput.
+//
+//               Compiled only with build flag AT24CXX_BENCH on a host
+//               build, e.g. PlatformIO environment native_bench.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : N/A
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_crc.h, at24cxx_scheduler.h,
+//                                    at24cxx_array.h, at24cxx_mirror.h
+//----------------------------------------------------------------------------
+
+#if defined(AT24CXX_BENCH) && !defined(ARDUINO)
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_crc.h"
+#include "at24cxx_scheduler.h"
+#include "at24cxx_array.h"
+#include "at24cxx_mirror.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+struct ChipEntry {
+    const char* name;
+    uint32_t chip;
+};
+
+const ChipEntry CHIPS[] = {
+    { "AT24C01", AT24C01 },   { "AT24C02", AT24C02 },
+    { "AT24C04", AT24C04 },   { "AT24C08", AT24C08 },
+    { "AT24C16", AT24C16 },   { "AT24C32", AT24C32 },
+    { "AT24C64", AT24C64 },   { "AT24C128", AT24C128 },
+    { "AT24C256", AT24C256 }, { "AT24C512", AT24C512 }
+};
+
+const uint32_t CLOCKS[] = { 100000, 400000, 1000000 };
+
+enum Operation { OP_BYTE, OP_PAGE, OP_UNALIGNED, OP_BULK };
+const char* const OPERATION_NAMES[] = { "byte", "page", "unaligned", "bulk" };
+
+const uint8_t BYTE_OPS = 32;
+const uint8_t PAGE_OPS = 8;
+
+struct Result {
+    uint32_t ops;
+    uint32_t failures;
+    uint32_t bytes;
+    uint64_t total_ns;
+    uint64_t max_ns;
+};
+
+typedef uint32_t (*CrcKernel)(uint32_t, const uint8_t*, size_t);
+
+struct KernelEntry {
+    const char* name;
+    CrcKernel kernel;
+};
+
+const KernelEntry KERNELS[] = {
+    { "bitwise", AT24CXXCrc::crc32Bitwise },
+    { "nibble", AT24CXXCrc::crc32Nibble },
+    { "slicing4", AT24CXXCrc::crc32Slicing4 },
+    { "slicing8", AT24CXXCrc::crc32Slicing8 }
+};
+
+const uint32_t RECORD_SIZES[] = { 16, 128, 4096, 65536 };
+
+const uint32_t SCENARIO_CLOCK = 400000;
+const uint8_t SCENARIO_CHIPS = 8;
+const uint16_t SCHEDULER_BYTES = 240;   // Per chip
+const uint32_t ARRAY_BYTES = 20000;
+const uint16_t MIRROR_BYTES = 4096;
+const uint16_t COMPARE_BYTES = 200;     // Struct rewritten with one change
+const uint16_t TRACKING_RECORDS = 256;
+const uint8_t TRACKING_RECORD_BYTES = 16;
+
+struct Scenario {
+    uint32_t failures;
+    uint32_t bytes;
+    uint64_t total_ns;
+    uint32_t write_cycles;
+    uint32_t transactions;
+};
+
+// Simulated chips at device addresses 0 onward, each with a driver
+class Rig {
+public:
+    Rig(uint32_t chip, uint8_t n_chips, bool ack_polling)
+    : _n_chips(n_chips),
+      _start_ns(0),
+      _start_cycles(0)
+    {
+        Wire.setClock(SCENARIO_CLOCK);
+        for (uint8_t i = 0; i < n_chips; i++) {
+            _sims[i] = new AT24CXXSim(chip, i, Wire);
+            devices[i].begin(chip, i, Wire);
+            if (ack_polling)
+                devices[i].setAckPolling();
+        }
+    }
+
+    ~Rig() {
+        for (uint8_t i = 0; i < _n_chips; i++)
+            delete _sims[i];
+    }
+
+    // Begin timing, after any untimed setup
+    void start() {
+        Wire.resetStats();
+        _start_cycles = writeCycles();
+        _start_ns = simClockNs();
+    }
+
+    // End timing of bytes moved, with failures counted by the caller
+    Scenario stop(uint32_t bytes, uint32_t failures) const {
+        Scenario result;
+        result.total_ns = simClockNs() - _start_ns;
+        result.failures = failures;
+        result.bytes = bytes;
+        result.write_cycles = writeCycles() - _start_cycles;
+        result.transactions = Wire.transactions();
+        return result;
+    }
+
+    uint8_t chips() const {
+        return _n_chips;
+    }
+
+    AT24CXX devices[SCENARIO_CHIPS];
+
+private:
+    Rig(const Rig&);
+    Rig& operator=(const Rig&);
+
+    uint32_t writeCycles() const {
+        uint32_t cycles = 0;
+        for (uint8_t i = 0; i < _n_chips; i++)
+            cycles += _sims[i]->writeCycles();
+        return cycles;
+    }
+
+    AT24CXXSim* _sims[SCENARIO_CHIPS];
+    uint8_t _n_chips;
+    uint64_t _start_ns;
+    uint32_t _start_cycles;
+};
+
+// Bytes hashed per kernel and record size
+const uint64_t CRC_BYTES = 1 << 26;
+
+uint8_t data[65536];
+uint8_t readback[65536];
+volatile uint32_t crc_sink = 0; // Keeps kernel results live
+bool json_output = false;
+bool first_row = true;
+uint32_t total_failures = 0;
+
+/*!
+    @brief Time one operation pattern on a chip
+    @param eeprom Driver attached to the simulated chip
+    @param write True to time writes, false for reads
+    @param op Access pattern
+    @return Accumulated operation count, bytes and simulated time
+*/
+Result run(AT24CXX& eeprom, bool write, Operation op) {
+    Result result = { 0, 0, 0, 0, 0 };
+    uint32_t chip_size = eeprom.size();
+    uint8_t page = eeprom.pageSize();
+    uint32_t n_pages = chip_size / page;
+    uint32_t n_ops = 1;
+    if (op == OP_BYTE)
+        n_ops = BYTE_OPS;
+    else if (op == OP_PAGE)
+        n_ops = (n_pages < PAGE_OPS) ? n_pages : PAGE_OPS;
+    else if (op == OP_UNALIGNED)
+        n_ops = (n_pages - 1 < PAGE_OPS) ? n_pages - 1 : PAGE_OPS;
+    for (uint32_t i = 0; i < n_ops; i++) {
+        uint32_t address = 0;
+        uint32_t n = chip_size;
+        if (op == OP_BYTE) {
+            address = (i * 613) % chip_size;
+            n = 1;
+        } else if (op == OP_PAGE) {
+            address = i * page;
+            n = page;
+        } else if (op == OP_UNALIGNED) {
+            address = i * page + page / 2;
+            n = page;
+        }
+        uint64_t start = simClockNs();
+        bool ok = write ? eeprom.write(address, &data[address], n)
+                        : eeprom.read(address, readback, n);
+        uint64_t elapsed = simClockNs() - start;
+        if (ok && !write && memcmp(readback, &data[address], n))
+            ok = false;
+        if (ok) {
+            result.ops++;
+            result.bytes += n;
+            result.total_ns += elapsed;
+            if (elapsed > result.max_ns)
+                result.max_ns = elapsed;
+        } else {
+            result.failures++;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Print one result row as CSV or JSON
+*/
+void emit(const char* chip, uint32_t clock, bool write, Operation op,
+          const Result& r) {
+    double total_us = r.total_ns / 1000.0;
+    double bytes_per_s = r.total_ns ? r.bytes * 1e9 / r.total_ns : 0.0;
+    double mean_us = r.ops ? total_us / r.ops : 0.0;
+    double max_us = r.max_ns / 1000.0;
+    const char* direction = write ? "write" : "read";
+    if (json_output) {
+        printf("%s\n  {\"chip\": \"%s\", \"clock_hz\": %u, "
+               "\"direction\": \"%s\", \"operation\": \"%s\", "
+               "\"ops\": %u, \"failures\": %u, \"bytes\": %u, "
+               "\"total_us\": %.1f, \"bytes_per_s\": %.0f, "
+               "\"mean_us\": %.1f, \"max_us\": %.1f}",
+               first_row ? "" : ",", chip, (unsigned)clock, direction,
+               OPERATION_NAMES[op], (unsigned)r.ops, (unsigned)r.failures,
+               (unsigned)r.bytes, total_us, bytes_per_s, mean_us, max_us);
+    } else {
+        printf("%s,%u,%s,%s,%u,%u,%u,%.1f,%.0f,%.1f,%.1f\n", chip,
+               (unsigned)clock, direction, OPERATION_NAMES[op],
+               (unsigned)r.ops, (unsigned)r.failures, (unsigned)r.bytes,
+               total_us, bytes_per_s, mean_us, max_us);
+    }
+    total_failures += r.failures;
+    first_row = false;
+}
+
+/*!
+    @brief Time each CRC-32 kernel on the host over records of each size
+*/
+void benchCrc() {
+    if (json_output)
+        printf("[");
+    else
+        printf("kernel,record_bytes,bytes,total_us,bytes_per_s,"
+               "ns_per_record\n");
+    for (const KernelEntry& entry : KERNELS) {
+        entry.kernel(0, data, 1); // Build any tables before timing
+        for (uint32_t size : RECORD_SIZES) {
+            uint64_t records = CRC_BYTES / size;
+            auto start = std::chrono::steady_clock::now();
+            for (uint64_t i = 0; i < records; i++) {
+                uint32_t offset = (uint32_t)((i * 64) % (65536 - size + 1));
+                crc_sink ^= entry.kernel(0, &data[offset], size);
+            }
+            auto stop = std::chrono::steady_clock::now();
+            double total_us =
+                std::chrono::duration<double, std::micro>(stop - start)
+                    .count();
+            double bytes = (double)records * size;
+            double bytes_per_s = total_us ? bytes * 1e6 / total_us : 0.0;
+            double ns_per_record = total_us * 1000.0 / records;
+            if (json_output) {
+                printf("%s\n  {\"kernel\": \"%s\", \"record_bytes\": %u, "
+                       "\"bytes\": %.0f, \"total_us\": %.1f, "
+                       "\"bytes_per_s\": %.0f, \"ns_per_record\": %.1f}",
+                       first_row ? "" : ",", entry.name, (unsigned)size,
+                       bytes, total_us, bytes_per_s, ns_per_record);
+            } else {
+                printf("%s,%u,%.0f,%.1f,%.0f,%.1f\n", entry.name,
+                       (unsigned)size, bytes, total_us, bytes_per_s,
+                       ns_per_record);
+            }
+            first_row = false;
+        }
+    }
+    if (json_output)
+        printf("\n]\n");
+}
+
+/*!
+    @brief Print one scenario row as CSV or JSON
+*/
+void emitScenario(const char* name, const char* variant, uint8_t chips,
+                  const Scenario& s) {
+    double total_us = s.total_ns / 1000.0;
+    double bytes_per_s = s.total_ns ? s.bytes * 1e9 / s.total_ns : 0.0;
+    if (json_output) {
+        printf("%s\n  {\"scenario\": \"%s\", \"variant\": \"%s\", "
+               "\"chips\": %u, \"failures\": %u, \"bytes\": %u, "
+               "\"total_us\": %.1f, \"bytes_per_s\": %.0f, "
+               "\"write_cycles\": %u, \"transactions\": %u}",
+               first_row ? "" : ",", name, variant, (unsigned)chips,
+               (unsigned)s.failures, (unsigned)s.bytes, total_us,
+               bytes_per_s, (unsigned)s.write_cycles,
+               (unsigned)s.transactions);
+    } else {
+        printf("%s,%s,%u,%u,%u,%.1f,%.0f,%u,%u\n", name, variant,
+               (unsigned)chips, (unsigned)s.failures, (unsigned)s.bytes,
+               total_us, bytes_per_s, (unsigned)s.write_cycles,
+               (unsigned)s.transactions);
+    }
+    total_failures += s.failures;
+    first_row = false;
+}
+
+/*!
+    @brief Count chips of a rig not holding n bytes of data at address
+*/
+uint32_t verifyChips(Rig& rig, uint16_t address, size_t n) {
+    uint32_t failures = 0;
+    for (uint8_t i = 0; i < rig.chips(); i++) {
+        if (!rig.devices[i].read(address, readback, n) ||
+            memcmp(readback, data, n))
+            failures++;
+    }
+    return failures;
+}
+
+/*!
+    @brief Write to eight AT24C512s one after another, then interleaved
+*/
+void benchScheduler() {
+    for (int scheduled = 0; scheduled <= 1; scheduled++) {
+        Rig rig(AT24C512, SCENARIO_CHIPS, false);
+        AT24CXXScheduler scheduler;
+        uint32_t failures = 0;
+        rig.start();
+        for (uint8_t i = 0; i < rig.chips(); i++) {
+            bool ok = scheduled
+                ? scheduler.submit(rig.devices[i], 0, data, SCHEDULER_BYTES)
+                : rig.devices[i].write(0, data, SCHEDULER_BYTES);
+            failures += !ok;
+        }
+        scheduler.flush();
+        Scenario s = rig.stop(SCENARIO_CHIPS * SCHEDULER_BYTES, failures);
+        s.failures += verifyChips(rig, 0, SCHEDULER_BYTES);
+        emitScenario("scheduler", scheduled ? "scheduled" : "serial",
+                     rig.chips(), s);
+    }
+}
+
+/*!
+    @brief Write to one AT24C512, then striped across eight
+*/
+void benchArray() {
+    for (int striped = 0; striped <= 1; striped++) {
+        Rig rig(AT24C512, striped ? SCENARIO_CHIPS : 1, true);
+        AT24CXXArray array;
+        for (uint8_t i = 0; i < rig.chips(); i++)
+            array.add(rig.devices[i]);
+        rig.start();
+        uint32_t failures = !array.write(3, data, ARRAY_BYTES);
+        Scenario s = rig.stop(ARRAY_BYTES, failures);
+        if (!array.read(3, readback, ARRAY_BYTES) ||
+            memcmp(readback, data, ARRAY_BYTES))
+            s.failures++;
+        emitScenario("array", striped ? "striped" : "single", rig.chips(),
+                     s);
+    }
+}
+
+/*!
+    @brief Write to two AT24C512s one after another, then mirrored
+*/
+void benchMirror() {
+    for (int mirrored = 0; mirrored <= 1; mirrored++) {
+        Rig rig(AT24C512, 2, true);
+        AT24CXXMirror mirror;
+        mirror.begin(rig.devices[0], rig.devices[1]);
+        uint32_t failures = 0;
+        rig.start();
+        if (mirrored) {
+            failures += !mirror.write(0, data, MIRROR_BYTES);
+        } else {
+            failures += !rig.devices[0].write(0, data, MIRROR_BYTES);
+            failures += !rig.devices[1].write(0, data, MIRROR_BYTES);
+        }
+        Scenario s = rig.stop(MIRROR_BYTES, failures);
+        s.failures += verifyChips(rig, 0, MIRROR_BYTES);
+        emitScenario("mirror", mirrored ? "mirrored" : "serial",
+                     rig.chips(), s);
+    }
+}
+
+/*!
+    @brief Rewrite an AT24C64 struct with one changed byte, then compared
+*/
+void benchCompare() {
+    for (int compare = 0; compare <= 1; compare++) {
+        Rig rig(AT24C64, 1, false);
+        uint8_t record[COMPARE_BYTES];
+        memcpy(record, data, COMPARE_BYTES);
+        uint32_t failures = !rig.devices[0].write(0, record,
+                                                  COMPARE_BYTES);
+        record[COMPARE_BYTES / 2] ^= 0xFF;
+        if (compare)
+            rig.devices[0].setWriteCompare();
+        rig.start();
+        failures += !rig.devices[0].write(0, record, COMPARE_BYTES);
+        Scenario s = rig.stop(COMPARE_BYTES, failures);
+        if (!rig.devices[0].read(0, readback, COMPARE_BYTES) ||
+            memcmp(readback, record, COMPARE_BYTES))
+            s.failures++;
+        emitScenario("compare", compare ? "compare" : "plain", rig.chips(),
+                     s);
+    }
+}
+
+/*!
+    @brief Read consecutive records from an AT24C512, then tracked
+*/
+void benchTracking() {
+    const uint32_t total = (uint32_t)TRACKING_RECORDS * TRACKING_RECORD_BYTES;
+    for (int tracked = 0; tracked <= 1; tracked++) {
+        Rig rig(AT24C512, 1, true);
+        uint32_t failures = !rig.devices[0].write(0, data, total);
+        if (tracked)
+            rig.devices[0].setAddressTracking();
+        rig.start();
+        for (uint32_t i = 0; i < total; i += TRACKING_RECORD_BYTES) {
+            if (!rig.devices[0].read((uint16_t)i, &readback[i],
+                                     TRACKING_RECORD_BYTES))
+                failures++;
+        }
+        Scenario s = rig.stop(total, failures);
+        if (memcmp(readback, data, total))
+            s.failures++;
+        emitScenario("tracking", tracked ? "tracked" : "addressed",
+                     rig.chips(), s);
+    }
+}
+
+/*!
+    @brief Run each multi-chip and mode comparison on the simulator
+*/
+void benchScenarios() {
+    if (json_output)
+        printf("[");
+    else
+        printf("scenario,variant,chips,failures,bytes,total_us,"
+               "bytes_per_s,write_cycles,transactions\n");
+    benchScheduler();
+    benchArray();
+    benchMirror();
+    benchCompare();
+    benchTracking();
+    if (json_output)
+        printf("\n]\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+    bool crc_mode = false;
+    bool scenario_mode = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--json"))
+            json_output = true;
+        else if (!strcmp(argv[i], "--crc"))
+            crc_mode = true;
+        else if (!strcmp(argv[i], "--scenarios"))
+            scenario_mode = true;
+    }
+    for (uint32_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t)(i * 131 + (i >> 8));
+    if (crc_mode) {
+        benchCrc();
+        return 0;
+    }
+    if (scenario_mode) {
+        benchScenarios();
+        return total_failures ? 1 : 0;
+    }
+
+    if (json_output)
+        printf("[");
+    else
+        printf("chip,clock_hz,direction,operation,ops,failures,bytes,"
+               "total_us,bytes_per_s,mean_us,max_us\n");
+    for (const ChipEntry& entry : CHIPS) {
+        for (uint32_t clock : CLOCKS) {
+            AT24CXXSim sim(entry.chip, 0, Wire);
+            AT24CXX eeprom;
+            Wire.setClock(clock);
+            eeprom.begin(entry.chip, 0, Wire);
+            eeprom.setAckPolling();
+            // Writes first, so that reads verify the written pattern
+            for (int w = 1; w >= 0; w--) {
+                for (int op = OP_BYTE; op <= OP_BULK; op++) {
+                    Result r = run(eeprom, w, (Operation)op);
+                    emit(entry.name, clock, w, (Operation)op, r);
+                }
+            }
+        }
+    }
+    if (json_output)
+        printf("\n]\n");
+    return total_failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_bus.h
+// Purpose     : AT24CXX EEPROM Bus Policy Classes
+// Description :
+//               These classes adapt an I2C implementation to the interface
+//               expected by the Bus parameter of AT24CXXStatic, so that the
+//               driver is bound to its bus at compile time. Each policy
+//               transfers the word address and data of a transaction in bulk
+//               and supplies the timing and pin functions the driver needs:
+//
+//                   Port               Type naming the bus at begin()
+//                   defaultPort()      Port used when none is given
+//                   MAX_TRANSFER       Largest write in bytes, incl. address
+//                   begin(port)        Bind to the bus
+//                   probe(addr)        True if device addr acknowledges
+//                   transmit(addr, header, header_len, data, n)
+//                                      Write header then data in one transfer
+//                   receive(addr, header, header_len, data, n)
+//                                      Write header (if any), then read n
+//                                      bytes after a repeated start
+//                   micros()           Free-running microsecond clock
+//                   delayMs(ms)        Blocking delay
+//                   pinOutput(pin)     Configure pin as output
+//                   writePin(pin, high) Drive output pin
+//
+//               Policies apply to AT24CXXStatic only; AT24CXX itself remains
+//               bound to TwoWire.
+//
+//               AT24CXXWireBus, in at24cxx_wirebus.h, uses an Arduino TwoWire
+//               object, and on host builds therefore drives the simulator of
+//               at24cxx_sim.h. This header itself does not depend on Wire.
+//               AT24CXXEspIdfBus uses the ESP-IDF I2C driver directly and is
+//               available where ESP_PLATFORM is defined. A Linux i2c-dev
+//               policy is provided separately in at24cxx_linux.h.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino, ESP-IDF
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx_chips.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_BUS_H
+#define AT24CXX_BUS_H
+
+#include "at24cxx_chips.h"
+
+#ifdef ESP_PLATFORM
+#include "driver/i2c.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+namespace PeripheralIO {
+
+class AT24CXXWireBus;
+// Arduino TwoWire policy, defined in at24cxx_wirebus.h
+
+#ifdef ESP_PLATFORM
+
+class AT24CXXEspIdfBus {
+public:
+    typedef i2c_port_t Port;
+    static constexpr size_t MAX_TRANSFER = 0xFFFF;
+
+    static Port defaultPort() { return I2C_NUM_0; }
+    // Driver must be installed with i2c_driver_install() beforehand
+
+    AT24CXXEspIdfBus() : _port(I2C_NUM_0) { }
+
+    void begin(Port port) { _port = port; }
+
+    bool probe(uint8_t addr) {
+        return transmit(addr, nullptr, 0, nullptr, 0);
+    }
+
+    bool transmit(uint8_t addr, const uint8_t* header, uint8_t header_len,
+                  const uint8_t* data, size_t n) {
+        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, (uint8_t)((addr << 1) | I2C_MASTER_WRITE),
+                              true);
+        if (header_len)
+            i2c_master_write(cmd, (uint8_t*)header, header_len, true);
+        if (n)
+            i2c_master_write(cmd, (uint8_t*)data, n, true);
+        i2c_master_stop(cmd);
+        esp_err_t err = i2c_master_cmd_begin(_port, cmd,
+                                             timeoutTicks(header_len + n));
+        i2c_cmd_link_delete(cmd);
+        return (err == ESP_OK);
+    }
+
+    bool receive(uint8_t addr, const uint8_t* header, uint8_t header_len,
+                 uint8_t* data, size_t n) {
+        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+        if (header_len) {
+            i2c_master_start(cmd);
+            i2c_master_write_byte(cmd,
+                                  (uint8_t)((addr << 1) | I2C_MASTER_WRITE),
+                                  true);
+            i2c_master_write(cmd, (uint8_t*)header, header_len, true);
+        }
+        i2c_master_start(cmd);
+        i2c_master_write_byte(cmd, (uint8_t)((addr << 1) | I2C_MASTER_READ),
+                              true);
+        if (n)
+            i2c_master_read(cmd, data, n, I2C_MASTER_LAST_NACK);
+        i2c_master_stop(cmd);
+        esp_err_t err = i2c_master_cmd_begin(_port, cmd,
+                                             timeoutTicks(header_len + n));
+        i2c_cmd_link_delete(cmd);
+        return (err == ESP_OK);
+    }
+
+    uint32_t micros() const { return (uint32_t)esp_timer_get_time(); }
+    void delayMs(uint32_t ms) const {
+        TickType_t ticks = pdMS_TO_TICKS(ms);
+        vTaskDelay(ticks ? ticks : 1);
+    }
+    void pinOutput(uint8_t pin) const {
+        gpio_set_direction((gpio_num_t)pin, GPIO_MODE_OUTPUT);
+    }
+    void writePin(uint8_t pin, bool high) const {
+        gpio_set_level((gpio_num_t)pin, high ? 1 : 0);
+    }
+
+private:
+    // Allows 90 us per byte, i.e. nine clocks at 100 kHz, on top of a fixed
+    // margin, so that a whole-chip read does not time out
+    static TickType_t timeoutTicks(size_t n) {
+        TickType_t ticks = pdMS_TO_TICKS(TIMEOUT_MS + (uint32_t)(n * 9 / 100));
+        return ticks ? ticks : 1;
+    }
+
+    static constexpr uint32_t TIMEOUT_MS = 50;
+
+    i2c_port_t _port;
+};
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,332 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_cache.cpp
+// Purpose     : AT24CXX EEPROM Page Cache Class
+// Description : This source file accompanies header file at24cxx_cache.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
+#include "at24cxx_cache.h"
+
+namespace PeripheralIO {
+
+AT24CXXCache::AT24CXXCache()
+: _device(nullptr),
+  _next_observer(nullptr),
+  _next_context(nullptr),
+  _buffer(nullptr),
+  _page_size(0),
+  _n_slots(0),
+  _slots(),
+  _tick(0),
+  _flush_ms(0),
+  _hits(0),
+  _misses(0)
+{ }
+
+AT24CXXCache::~AT24CXXCache() {
+    detach();
+}
+
+/*!
+    @brief Attach cache to AT24CXX chip
+    @param device Chip initialized with begin()
+    @param buffer Memory for cached pages
+    @param buffer_size Size of buffer in bytes
+    @return False for buffer smaller than one page
+*/
+bool AT24CXXCache::begin(AT24CXX& device, uint8_t buffer[],
+                         size_t buffer_size) {
+    detach();
+    _device = &device;
+    _buffer = buffer;
+    _page_size = device.pageSize();
+    _n_slots = 0;
+    if (_page_size) {
+        size_t n_slots = buffer_size / _page_size;
+        _n_slots = (n_slots > MAX_PAGES) ? MAX_PAGES : (uint8_t)n_slots;
+    }
+    for (uint8_t i = 0; i < MAX_PAGES; i++)
+        _slots[i].valid = false;
+    // Chain to any other observer of the chip
+    _next_observer = device.writeObserver(&_next_context);
+    device.setWriteObserver(onDeviceWrite, this);
+    return (_n_slots > 0);
+}
+
+/*!
+    @brief Write byte to cache
+    @param address Address to write byte
+    @param val Byte to write
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+bool AT24CXXCache::write(uint16_t address, uint8_t val) {
+    return write(address, &val, 1);
+}
+
+/*!
+    @brief Write n bytes to cache from vals
+    @param address Address to write bytes
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+bool AT24CXXCache::write(uint16_t address, const uint8_t vals[], size_t n) {
+    bool result = false;
+    if (_n_slots && (address + n <= _device->size())) {
+        size_t done = 0;
+        result = true;
+        while (result && (done < n)) {
+            uint16_t page = (uint16_t)((address + done) / _page_size);
+            uint8_t offset = (uint8_t)((address + done) % _page_size);
+            size_t len = _page_size - offset;
+            if (len > n - done)
+                len = n - done;
+            int8_t i = lookup(page);
+            if (i < 0) {
+                result = false;
+            } else {
+                Slot& slot = _slots[i];
+                memcpy(&_buffer[i * _page_size + offset], &vals[done], len);
+                if (slot.dirty_hi == slot.dirty_lo) {
+                    slot.dirty_lo = offset;
+                    slot.dirty_hi = offset + len;
+                    slot.dirty_since = millis();
+                } else {
+                    if (offset < slot.dirty_lo)
+                        slot.dirty_lo = offset;
+                    if (offset + len > slot.dirty_hi)
+                        slot.dirty_hi = offset + len;
+                }
+                done += len;
+            }
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Read byte through cache
+    @param address Address to read byte
+    @return Byte read
+*/
+uint8_t AT24CXXCache::read(uint16_t address) {
+    uint8_t byte = 0;
+    read(address, &byte, 1);
+    return byte;
+}
+
+/*!
+    @brief Read n successive bytes through cache
+    @param address Address to read bytes
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for failed to read (e.g. invalid memory regions)
+*/
+bool AT24CXXCache::read(uint16_t address, uint8_t vals[], size_t n) {
+    bool result = false;
+    if (_n_slots && (address + n <= _device->size())) {
+        size_t done = 0;
+        result = true;
+        while (result && (done < n)) {
+            uint16_t page = (uint16_t)((address + done) / _page_size);
+            uint8_t offset = (uint8_t)((address + done) % _page_size);
+            size_t len = _page_size - offset;
+            if (len > n - done)
+                len = n - done;
+            int8_t i = lookup(page);
+            if (i < 0)
+                result = _device->read((uint16_t)(address + done),
+                                       &vals[done], len);
+            else
+                memcpy(&vals[done], &_buffer[i * _page_size + offset], len);
+            done += len;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Write all dirty pages to chip
+    @return False for failed write
+*/
+bool AT24CXXCache::flush() {
+    bool result = true;
+    for (uint8_t i = 0; i < _n_slots; i++) {
+        if (!flushSlot(i))
+            result = false;
+    }
+    return result;
+}
+
+/*!
+    @brief Set age after which service() flushes dirty pages
+    @param ms Flush interval in milliseconds, zero to disable
+*/
+void AT24CXXCache::setFlushInterval(uint32_t ms) {
+    _flush_ms = ms;
+}
+
+/*!
+    @brief Flush pages dirty for longer than the flush interval
+    @return False for failed write
+*/
+bool AT24CXXCache::service() {
+    bool result = true;
+    if (_flush_ms) {
+        uint32_t now = millis();
+        for (uint8_t i = 0; i < _n_slots; i++) {
+            Slot& slot = _slots[i];
+            if (slot.valid && (slot.dirty_hi != slot.dirty_lo) &&
+                ((uint32_t)(now - slot.dirty_since) >= _flush_ms) &&
+                !flushSlot(i))
+                result = false;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Count page accesses served from the cache
+    @return Number of hits
+*/
+uint32_t AT24CXXCache::hits() const {
+    return _hits;
+}
+
+/*!
+    @brief Count page accesses that loaded from the chip
+    @return Number of misses
+*/
+uint32_t AT24CXXCache::misses() const {
+    return _misses;
+}
+
+// Private: Slot holding page, loading it on a miss, or -1 on failure
+int8_t AT24CXXCache::lookup(uint16_t page) {
+    int8_t index = find(page);
+    if (index < 0) {
+        _misses++;
+        index = load(page);
+    } else {
+        _hits++;
+        _slots[index].used = ++_tick;
+    }
+    return index;
+}
+
+// Private: Slot holding page, or -1 if not cached
+int8_t AT24CXXCache::find(uint16_t page) const {
+    int8_t index = -1;
+    for (uint8_t i = 0; (index < 0) && (i < _n_slots); i++) {
+        if (_slots[i].valid && (_slots[i].page == page))
+            index = (int8_t)i;
+    }
+    return index;
+}
+
+// Private: Load page into least recently used slot, or -1 on failure
+int8_t AT24CXXCache::load(uint16_t page) {
+    uint8_t victim = 0;
+    for (uint8_t i = 0; i < _n_slots; i++) {
+        if (!_slots[i].valid) {
+            victim = i;
+            break;
+        }
+        if (_slots[i].used < _slots[victim].used)
+            victim = i;
+    }
+    int8_t index = -1;
+    if (flushSlot(victim)) {
+        Slot& slot = _slots[victim];
+        slot.valid = _device->read((uint16_t)(page * _page_size),
+                                   &_buffer[victim * _page_size],
+                                   _page_size);
+        if (slot.valid) {
+            slot.page = page;
+            slot.dirty_lo = 0;
+            slot.dirty_hi = 0;
+            slot.used = ++_tick;
+            index = (int8_t)victim;
+        }
+    }
+    return index;
+}
+
+// Private: Write observer copying data written to the chip into the cache
+void AT24CXXCache::onDeviceWrite(uint16_t address, const uint8_t* vals,
+                                 uint16_t n, void* context) {
+    AT24CXXCache* cache = (AT24CXXCache*)context;
+    uint8_t page_size = cache->_page_size;
+    uint16_t done = 0;
+    while (done < n) {
+        uint16_t page = (uint16_t)((address + done) / page_size);
+        uint8_t offset = (uint8_t)((address + done) % page_size);
+        uint16_t len = page_size - offset;
+        if (len > n - done)
+            len = n - done;
+        int8_t i = cache->find(page);
+        if (i >= 0) {
+            uint8_t* cached = &cache->_buffer[i * page_size + offset];
+            if (cached != &vals[done])
+                memcpy(cached, &vals[done], len);
+        }
+        done += len;
+    }
+    if (cache->_next_observer)
+        cache->_next_observer(address, vals, n, cache->_next_context);
+}
+
+// Private: Remove cache from the chain of write observers of its chip
+void AT24CXXCache::detach() {
+    if (_device) {
+        // Later caches of the same chip are chained ahead of this one
+        AT24CXXCache* prev = nullptr;
+        void* context = nullptr;
+        AT24CXXWriteObserver observer = _device->writeObserver(&context);
+        while ((observer == onDeviceWrite) && context && (context != this)) {
+            prev = (AT24CXXCache*)context;
+            observer = prev->_next_observer;
+            context = prev->_next_context;
+        }
+        if ((observer == onDeviceWrite) && (context == this)) {
+            if (prev) {
+                prev->_next_observer = _next_observer;
+                prev->_next_context = _next_context;
+            } else {
+                _device->setWriteObserver(_next_observer, _next_context);
+            }
+        }
+        _device = nullptr;
+        _next_observer = nullptr;
+        _next_context = nullptr;
+    }
+}
+
+// Private: Write dirty span of slot to chip
+bool AT24CXXCache::flushSlot(uint8_t index) {
+    bool result = true;
+    Slot& slot = _slots[index];
+    if (slot.valid && (slot.dirty_hi != slot.dirty_lo)) {
+        uint8_t* span = &_buffer[index * _page_size + slot.dirty_lo];
+        result = _device->write((uint16_t)(slot.page * _page_size +
+                                           slot.dirty_lo),
+                                span, slot.dirty_hi - slot.dirty_lo);
+        if (result) {
+            slot.dirty_lo = 0;
+            slot.dirty_hi = 0;
+        }
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,124 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_cache.h
+// Purpose     : AT24CXX EEPROM Page Cache Class
+// Description :
+//               This class layers a RAM cache of whole pages over an AT24CXX
+//               chip. Reads are served from cached pages, and a page missing
+//               from the cache is loaded whole, replacing the least recently
+//               used page. Hits and misses are counted.
+//
+//               The cache is write-back. Writes are absorbed into page-aligned
+//               buffers and the modified span of each page is marked dirty.
+//               Dirty pages are written to the chip as a single page write
+//               on flush(), when evicted to make room for another page, or
+//               from service() once they have been dirty for longer than
+//               the interval set by setFlushInterval().
+//
+//               Cache memory is supplied by the caller at begin(), and holds
+//               as many whole pages as fit, up to MAX_PAGES. Pages are
+//               loaded from the chip on first access, so that cached pages
+//               always hold the complete page content.
+//
+//               The cache registers itself as the chip's write observer, so
+//               writes made directly through the AT24CXX instance update any
+//               cached copy of the pages they touch. An observer already
+//               registered, e.g. a second cache of the same chip, is called
+//               in turn after the cache, so that each layer stays coherent.
+//               The cache removes itself from the chain when destroyed or
+//               attached to another chip.
+//
+//               Data held in dirty pages is lost if power fails before the
+//               pages are flushed.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_CACHE_H
+#define AT24CXX_CACHE_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXCache {
+public:
+    AT24CXXCache();
+    ~AT24CXXCache();
+
+    bool begin(AT24CXX& device, uint8_t buffer[], size_t buffer_size);
+    // Attach cache to a chip initialized with begin()
+    // Parameter buffer provides cache memory of buffer_size bytes
+    // Returns false if buffer cannot hold at least one page
+
+    bool write(uint16_t address, uint8_t val);
+    // Write value to cached EEPROM address
+    // Returns false for invalid memory regions or failed page load
+
+    bool write(uint16_t address, const uint8_t vals[], size_t n);
+    // Write n successive values to cached address
+    // Returns false for invalid memory regions or failed page load
+
+    uint8_t read(uint16_t address);
+    // Read value from cached EEPROM address
+
+    bool read(uint16_t address, uint8_t vals[], size_t n);
+    // Read n successive values, served from cache where present
+    // Returns false for invalid memory regions or failed read
+
+    bool flush();
+    // Write all dirty pages to the chip
+    // Returns false for failed write
+
+    void setFlushInterval(uint32_t ms);
+    // Flush pages from service() once dirty for ms, zero to disable
+
+    bool service();
+    // Flush pages dirty for longer than the flush interval
+    // Returns false for failed write
+
+    uint32_t hits() const;
+    // Returns number of page accesses served from the cache
+
+    uint32_t misses() const;
+    // Returns number of page accesses that loaded from the chip
+
+    static const uint8_t MAX_PAGES = 32;
+
+private:
+    struct Slot {
+        uint16_t page;
+        uint8_t dirty_lo;
+        uint8_t dirty_hi;
+        bool valid;
+        uint32_t used;
+        uint32_t dirty_since;
+    };
+
+    int8_t find(uint16_t) const;
+    int8_t load(uint16_t);
+    bool flushSlot(uint8_t);
+    int8_t lookup(uint16_t);
+    void detach();
+
+    static void onDeviceWrite(uint16_t, const uint8_t*, uint16_t, void*);
+
+    AT24CXX* _device;
+    AT24CXXWriteObserver _next_observer;
+    void* _next_context;
+    uint8_t* _buffer;
+    uint8_t _page_size;
+    uint8_t _n_slots;
+    Slot _slots[MAX_PAGES];
+    uint32_t _tick;
+    uint32_t _flush_ms;
+    uint32_t _hits;
+    uint32_t _misses;
+};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_chips.h
+// Purpose     : AT24CXX EEPROM Chip Definitions
+// Description :
+//               This header defines the chip selection constants, their
+//               compile-time traits and the bus constants common to all
+//               drivers. It depends on neither Arduino nor Wire, so that
+//               AT24CXXStatic may be built with a non-Arduino bus policy,
+//               e.g. AT24CXXLinuxBus, without the rest of the library.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : N/A
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : N/A
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_CHIPS_H
+#define AT24CXX_CHIPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PeripheralIO {
+
+// Chip Selection (word size | page size | addr bytes | addr overflow bits)
+// AT24C01 and AT24C04 not tested
+constexpr uint32_t AT24C01 = 128 | (8 << 20) | (1 << 28) | (0u << 30);
+constexpr uint32_t AT24C02 = 256 | (8 << 20) | (1 << 28) | (0u << 30);
+constexpr uint32_t AT24C04 = 512 | (16 << 20) | (1 << 28) | (1u << 30);
+constexpr uint32_t AT24C08 = 1024 | (16 << 20) | (1 << 28) | (2u << 30);
+constexpr uint32_t AT24C16 = 2048 | (16 << 20) | (1 << 28) | (3u << 30);
+constexpr uint32_t AT24C32 = 4096 | (32 << 20) | (2 << 28) | (0u << 30);
+constexpr uint32_t AT24C64 = 8192 | (32 << 20) | (2 << 28) | (0u << 30);
+constexpr uint32_t AT24C128 = 16384 | (64 << 20) | (2 << 28) | (0u << 30);
+constexpr uint32_t AT24C256 = 32768 | (64 << 20) | (2 << 28) | (0u << 30);
+constexpr uint32_t AT24C512 = 65536 | (128 << 20) | (2 << 28) | (0u << 30);
+
+template <uint32_t Chip>
+struct AT24CXXTraits {
+    static constexpr uint32_t chip_size = Chip & 0x0001FFFF;
+    static constexpr uint8_t page_size = (uint8_t)((Chip & 0x0FF00000) >> 20);
+    static constexpr uint8_t addr_bytes = (uint8_t)((Chip & 0x30000000) >> 28);
+    static constexpr uint8_t addr_ov_bits =
+        (uint8_t)((Chip & 0xC0000000) >> 30);
+};
+// Chip parameters resolved at compile time, e.g. AT24CXXTraits<AT24C512>
+
+constexpr uint8_t AT24CXX_MAX_PAGE_SIZE = 128;
+// Largest page of any supported chip (AT24C512)
+
+constexpr uint8_t AT24CXX_ADDR = 0x50;
+// 7-bit device address with A2-A0 low
+
+constexpr uint8_t EEPROM_WRITE_CYCLE_TIME_MS = 5;
+// Datasheet maximum write cycle time
+
+}
+
+#endif
@@ -0,0 +1,299 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_crc.cpp
+// Purpose     : AT24CXX EEPROM CRC-32 Integrity Class
+// Description : This source file accompanies header file at24cxx_crc.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#ifdef ESP_PLATFORM
+#include <esp_rom_crc.h>
+#endif
+#include <string.h>
+#include "at24cxx_crc.h"
+
+namespace PeripheralIO {
+
+// Reflected polynomial of CRC-32 (IEEE 802.3)
+const uint32_t CRC32_POLY = 0xEDB88320;
+// Bytes read per transfer by verify()
+const uint8_t VERIFY_CHUNK = 32;
+
+AT24CXXCrc::AT24CXXCrc()
+: _device(nullptr),
+  _failures(0)
+{ }
+
+/*!
+    @brief Attach integrity layer to AT24CXX chip
+    @param device Chip initialized with begin()
+*/
+void AT24CXXCrc::begin(AT24CXX& device) {
+    _device = &device;
+    _failures = 0;
+}
+
+/*!
+    @brief Write n bytes followed by their CRC-32
+    @param address Address to write record
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @return False for record beyond the chip or failed write
+*/
+bool AT24CXXCrc::write(uint16_t address, const uint8_t vals[], size_t n) {
+    bool result = false;
+    if (_device && ((uint32_t)address + n + CRC_SIZE <= _device->size())) {
+        // Filled by onChunk() once the last byte of the record has passed,
+        // before the page holding it is sent; an empty record has CRC zero
+        uint8_t stored[CRC_SIZE] = { 0, 0, 0, 0 };
+        Running run = { 0, n, stored };
+        result = _device->write(address, vals, n, stored, CRC_SIZE, onChunk,
+                                &run);
+    }
+    return result;
+}
+
+/*!
+    @brief Read n bytes and check the CRC-32 following them
+    @param address Address to read record
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for CRC mismatch, record beyond the chip or failed read
+*/
+bool AT24CXXCrc::read(uint16_t address, uint8_t vals[], size_t n) {
+    bool result = false;
+    if (_device && ((uint32_t)address + n + CRC_SIZE <= _device->size())) {
+        uint8_t stored[CRC_SIZE];
+        Running run = { 0, n, nullptr };
+        result = _device->read(address, vals, n, stored, CRC_SIZE, onChunk,
+                               &run);
+        if (result && (run.crc != loadCrc(stored))) {
+            _failures++;
+            result = false;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Check CRC-32 of record without returning its contents
+    @param address Address of record
+    @param n Number of bytes in record, excluding the CRC
+    @return False for CRC mismatch, record beyond the chip or failed read
+*/
+bool AT24CXXCrc::verify(uint16_t address, size_t n) {
+    bool result = false;
+    if (_device && ((uint32_t)address + n + CRC_SIZE <= _device->size())) {
+        uint8_t chunk[VERIFY_CHUNK];
+        uint8_t stored[CRC_SIZE];
+        uint32_t crc = 0;
+        size_t done = 0;
+        do {
+            size_t len = (n - done < VERIFY_CHUNK) ? n - done : VERIFY_CHUNK;
+            uint16_t at = (uint16_t)(address + done);
+            // The last chunk reads on into the stored CRC
+            result = (done + len < n) ? _device->read(at, chunk, len)
+                                      : _device->read(at, chunk, len, stored,
+                                                      CRC_SIZE);
+            crc = crc32(crc, chunk, len);
+            done += len;
+        } while (result && (done < n));
+        if (result && (crc != loadCrc(stored))) {
+            _failures++;
+            result = false;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Count of records failing their CRC check
+    @return Number of failed checks by read() and verify()
+*/
+uint32_t AT24CXXCrc::failures() const {
+    return _failures;
+}
+
+/*!
+    @brief CRC-32 using the kernel selected for the platform
+    @param crc Result of previous call, or zero to start
+    @param data Pointer to array of bytes
+    @param n Number of bytes
+    @return CRC-32 of all bytes so far
+*/
+uint32_t AT24CXXCrc::crc32(uint32_t crc, const uint8_t* data, size_t n) {
+#if defined(ESP_PLATFORM)
+    return esp_rom_crc32_le(crc, data, (uint32_t)n);
+#elif defined(__AVR__)
+    return crc32Nibble(crc, data, n);
+#else
+    return crc32Slicing4(crc, data, n);
+#endif
+}
+
+/*!
+    @brief CRC-32 one bit at a time, without tables
+    @param crc Result of previous call, or zero to start
+    @param data Pointer to array of bytes
+    @param n Number of bytes
+    @return CRC-32 of all bytes so far
+*/
+uint32_t AT24CXXCrc::crc32Bitwise(uint32_t crc, const uint8_t* data,
+                                  size_t n) {
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (CRC32_POLY & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+/*!
+    @brief CRC-32 four bits at a time from a 64-byte table
+    @param crc Result of previous call, or zero to start
+    @param data Pointer to array of bytes
+    @param n Number of bytes
+    @return CRC-32 of all bytes so far
+*/
+uint32_t AT24CXXCrc::crc32Nibble(uint32_t crc, const uint8_t* data,
+                                 size_t n) {
+    static const uint32_t TABLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+        crc = (crc >> 4) ^ TABLE[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+/*!
+    @brief CRC-32 four bytes at a time from 4 KB of tables
+    @param crc Result of previous call, or zero to start
+    @param data Pointer to array of bytes
+    @param n Number of bytes
+    @return CRC-32 of all bytes so far
+*/
+uint32_t AT24CXXCrc::crc32Slicing4(uint32_t crc, const uint8_t* data,
+                                   size_t n) {
+    static uint32_t table[4][256];
+    static bool built = false;
+    if (!built) {
+        buildTable(table, 4);
+        built = true;
+    }
+    crc = ~crc;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        // Assembled bytewise, so independent of endianness and alignment
+        crc ^= (uint32_t)data[i] | ((uint32_t)data[i + 1] << 8) |
+               ((uint32_t)data[i + 2] << 16) | ((uint32_t)data[i + 3] << 24);
+        crc = table[3][crc & 0xFF] ^ table[2][(crc >> 8) & 0xFF] ^
+              table[1][(crc >> 16) & 0xFF] ^ table[0][crc >> 24];
+    }
+    for (; i < n; i++)
+        crc = (crc >> 8) ^ table[0][(crc ^ data[i]) & 0xFF];
+    return ~crc;
+}
+
+/*!
+    @brief CRC-32 eight bytes at a time from 8 KB of tables
+    @param crc Result of previous call, or zero to start
+    @param data Pointer to array of bytes
+    @param n Number of bytes
+    @return CRC-32 of all bytes so far
+*/
+uint32_t AT24CXXCrc::crc32Slicing8(uint32_t crc, const uint8_t* data,
+                                   size_t n) {
+    static uint32_t table[8][256];
+    static bool built = false;
+    if (!built) {
+        buildTable(table, 8);
+        built = true;
+    }
+    crc = ~crc;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        crc ^= (uint32_t)data[i] | ((uint32_t)data[i + 1] << 8) |
+               ((uint32_t)data[i + 2] << 16) | ((uint32_t)data[i + 3] << 24);
+        crc = table[7][crc & 0xFF] ^ table[6][(crc >> 8) & 0xFF] ^
+              table[5][(crc >> 16) & 0xFF] ^ table[4][crc >> 24] ^
+              table[3][data[i + 4]] ^ table[2][data[i + 5]] ^
+              table[1][data[i + 6]] ^ table[0][data[i + 7]];
+    }
+    for (; i < n; i++)
+        crc = (crc >> 8) ^ table[0][(crc ^ data[i]) & 0xFF];
+    return ~crc;
+}
+
+/*!
+    @brief CRC-8 with polynomial 0x07, one bit at a time
+    @param crc Result of previous call, or zero to start
+    @param data Pointer to array of bytes
+    @param n Number of bytes
+    @return CRC-8 of all bytes so far
+*/
+uint8_t AT24CXXCrc::crc8(uint8_t crc, const uint8_t* data, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07)
+                               : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+// Private: Fill rows of slicing tables, row k advancing k further bytes
+void AT24CXXCrc::buildTable(uint32_t table[][256], uint8_t rows) {
+    for (uint16_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (CRC32_POLY & (0 - (crc & 1)));
+        table[0][i] = crc;
+    }
+    for (uint8_t k = 1; k < rows; k++) {
+        for (uint16_t i = 0; i < 256; i++)
+            table[k][i] = (table[k - 1][i] >> 8) ^
+                          table[0][table[k - 1][i] & 0xFF];
+    }
+}
+
+// Private: Continue CRC with a transfer's share of a record, storing the
+// result where requested once the whole record has passed
+void AT24CXXCrc::onChunk(const uint8_t* vals, size_t n, void* context) {
+    Running* run = (Running*)context;
+    run->crc = crc32(run->crc, vals, n);
+    run->left -= n;
+    if (!run->left && run->stored)
+        storeCrc(run->crc, run->stored);
+}
+
+// Private: CRC stored least significant byte first
+uint32_t AT24CXXCrc::loadCrc(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+// Private: Counterpart of loadCrc()
+void AT24CXXCrc::storeCrc(uint32_t crc, uint8_t* bytes) {
+    bytes[0] = (uint8_t)crc;
+    bytes[1] = (uint8_t)(crc >> 8);
+    bytes[2] = (uint8_t)(crc >> 16);
+    bytes[3] = (uint8_t)(crc >> 24);
+}
+
+}
@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_crc.h
+// Purpose     : AT24CXX EEPROM CRC-32 Integrity Class
+// Description :
+//               This class stores records on an AT24CXX chip followed by
+//               a CRC-32 (IEEE 802.3, as zlib) of their contents, and checks
+//               it on every read, so that corruption from a torn write,
+//               worn page or bus error is reported rather than returned.
+//
+//               A record of n bytes occupies n + 4 bytes on the chip. The
+//               record and its CRC go out as one write of AT24CXX with a
+//               trailer, which hands each page's share of the record to
+//               the CRC just before sending it, so the CRC is complete by
+//               the time the page holding it is sent and shares that page
+//               with the last bytes of the record. A record that ends on a
+//               page boundary, or fewer than 4 bytes before one, costs one
+//               more write cycle for the CRC, e.g. 32 bytes at address 0 of
+//               an AT24C64 take two.
+//
+//               Reading is likewise one sequential read of record and CRC,
+//               with the CRC fed from each bus transfer as it arrives
+//               rather than from a second pass over the buffer. It bypasses
+//               setPrefetch(). verify() checks a record without a caller
+//               buffer, feeding the CRC from successive short reads, the
+//               last of which carries the stored CRC.
+//
+//               The CRC kernel is chosen at build time: the ROM routine on
+//               ESP32, a 16-entry table on AVR where RAM is scarce, and
+//               slicing-by-4 tables (4 KB, built on first use) elsewhere.
+//               All kernels are public and interchangeable, continuing from
+//               a previous result, e.g. crc32(crc32(0, a, n), b, m) is the
+//               CRC of a followed by b.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_CRC_H
+#define AT24CXX_CRC_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXCrc {
+public:
+    AT24CXXCrc();
+
+    void begin(AT24CXX& device);
+    // Attach to a chip initialized with begin()
+
+    bool write(uint16_t address, const uint8_t vals[], size_t n);
+    // Write n values to address followed by their CRC-32
+    // Returns false for record beyond the chip or failed write
+
+    bool read(uint16_t address, uint8_t vals[], size_t n);
+    // Read n values from address and check the CRC-32 following them
+    // Returns false for CRC mismatch, record beyond the chip or failed read
+
+    bool verify(uint16_t address, size_t n);
+    // Check CRC-32 of the n-byte record at address without returning it
+    // Returns false for CRC mismatch or failed read
+
+    uint32_t failures() const;
+    // Returns number of records that failed their CRC check
+
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t n);
+    // Returns CRC-32 of n bytes continuing from crc, zero to start,
+    // using the kernel selected for the platform
+
+    static uint32_t crc32Bitwise(uint32_t crc, const uint8_t* data,
+                                 size_t n);
+    static uint32_t crc32Nibble(uint32_t crc, const uint8_t* data, size_t n);
+    static uint32_t crc32Slicing4(uint32_t crc, const uint8_t* data,
+                                  size_t n);
+    static uint32_t crc32Slicing8(uint32_t crc, const uint8_t* data,
+                                  size_t n);
+    // Individual kernels, e.g. for benchmarks; results are identical
+
+    static uint8_t crc8(uint8_t crc, const uint8_t* data, size_t n);
+    // Returns CRC-8 (polynomial 0x07) of n bytes continuing from crc,
+    // as used for the short checks of the key-value, log and shadow layers
+
+    static const uint8_t CRC_SIZE = 4;
+
+private:
+    struct Running {
+        uint32_t crc;
+        size_t left;
+        uint8_t* stored;
+    };
+
+    static void buildTable(uint32_t table[][256], uint8_t rows);
+    static void onChunk(const uint8_t*, size_t, void*);
+    static uint32_t loadCrc(const uint8_t*);
+    static void storeCrc(uint32_t, uint8_t*);
+
+    AT24CXX* _device;
+    uint32_t _failures;
+};
+
+}
+
+#endif
@@ -0,0 +1,443 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_kv.cpp
+// Purpose     : AT24CXX EEPROM Log-Structured Key-Value Store Class
+// Description : This source file accompanies header file at24cxx_kv.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
+#include "at24cxx_kv.h"
+#include "at24cxx_crc.h"
+
+namespace PeripheralIO {
+
+// Page header: sequence number (4), pages in log when opened (2), check (1)
+// Record: key (2), value length (1), check (1), value
+const uint8_t PAGE_HEADER_SIZE = 7;
+const uint8_t RECORD_HEADER_SIZE = 4;
+const uint16_t EMPTY_KEY = 0xFFFF;
+
+AT24CXXKV::AT24CXXKV()
+: _device(nullptr),
+  _index(nullptr),
+  _capacity(0),
+  _count(0),
+  _first_page(0),
+  _n_pages(0),
+  _page_size(0),
+  _head(0),
+  _tail(0),
+  _used(0),
+  _seq(0),
+  _fill(0),
+  _flushed(0),
+  _live_bytes(0),
+  _page(),
+  _scratch()
+{ }
+
+/*!
+    @brief Mount key-value store on region of AT24CXX chip
+    @param device Chip initialized with begin()
+    @param start First address of region, rounded up to a page boundary
+    @param length Length of region in bytes
+    @param index Memory for index entries
+    @param capacity Number of entries in index
+    @return False for region too small, unsupported chip or failed read
+*/
+bool AT24CXXKV::begin(AT24CXX& device, uint16_t start, uint16_t length,
+                      AT24CXXKVEntry index[], uint16_t capacity) {
+    bool result = false;
+    _device = nullptr;
+    _index = index;
+    _capacity = capacity;
+    _count = 0;
+    _live_bytes = 0;
+    _page_size = device.pageSize();
+    if ((_page_size >= 16) && (_page_size <= MAX_PAGE_SIZE)) {
+        uint32_t end = (uint32_t)start + length;
+        if (end > device.size())
+            end = device.size();
+        _first_page = (uint16_t)((start + _page_size - 1) / _page_size);
+        uint16_t last_page = (uint16_t)(end / _page_size);
+        _n_pages = (last_page > _first_page) ? last_page - _first_page : 0;
+        _device = &device;
+        result = (_n_pages >= 3) && mount();
+        if (!result)
+            _device = nullptr;
+    }
+    return result;
+}
+
+/*!
+    @brief Store value under key
+    @param key Key of value, any but 0xFFFF
+    @param value Pointer to bytes of value
+    @param n Length of value
+    @return False for value too long, index full, region full or failed write
+*/
+bool AT24CXXKV::put(uint16_t key, const uint8_t value[], uint8_t n) {
+    bool result = false;
+    int32_t i = find(key);
+    // Live records are limited to 3/4 of all but two pages, leaving room
+    // for page tails too short for a record and for moving the log
+    uint32_t live = _live_bytes + RECORD_HEADER_SIZE + n;
+    uint32_t limit = (uint32_t)(_n_pages - 2) *
+                     (_page_size - PAGE_HEADER_SIZE) * 3 / 4;
+    if (i >= 0)
+        live -= RECORD_HEADER_SIZE + _index[i].length;
+    if (_device && (key != EMPTY_KEY) && (n <= maxValue()) &&
+        ((i >= 0) || (_count < _capacity)) && (live <= limit)) {
+        result = true;
+        if (_fill + RECORD_HEADER_SIZE + n > _page_size)
+            result = reclaim();
+        result = result && append(key, value, n);
+    }
+    return result;
+}
+
+/*!
+    @brief Read value stored under key
+    @param key Key of value
+    @param value Pointer to array value will be written to
+    @param n Maximum number of bytes to read
+    @return False if key is absent or for failed read
+*/
+bool AT24CXXKV::get(uint16_t key, uint8_t value[], uint8_t n) const {
+    bool result = false;
+    int32_t i = find(key);
+    if (i >= 0) {
+        const AT24CXXKVEntry& entry = _index[i];
+        uint16_t address = entry.address + RECORD_HEADER_SIZE;
+        if (n > entry.length)
+            n = entry.length;
+        uint16_t tail = pageAddress(_tail);
+        if ((address >= tail) && (address < tail + _page_size)) {
+            memcpy(value, &_page[address - tail], n);
+            result = true;
+        } else {
+            result = _device->read(address, value, (size_t)n);
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Length of value stored under key
+    @param key Key of value
+    @return Length in bytes, zero if absent
+*/
+uint8_t AT24CXXKV::length(uint16_t key) const {
+    int32_t i = find(key);
+    return (i >= 0) ? _index[i].length : 0;
+}
+
+/*!
+    @brief Write buffered records to the chip
+    @return False for failed write
+*/
+bool AT24CXXKV::flush() {
+    return (_device && writeTail());
+}
+
+/*!
+    @brief Reclaim oldest page ahead of need when worthwhile
+    @return True while further reclaiming is worthwhile
+*/
+bool AT24CXXKV::service() {
+    bool worthwhile = false;
+    if (_device) {
+        uint16_t threshold = (_n_pages / 4 > 2) ? _n_pages / 4 : 2;
+        uint8_t area = _page_size - PAGE_HEADER_SIZE;
+        worthwhile = (freePages() < threshold) && (_used > 1) &&
+                     (deadBytes() >= area);
+        if (worthwhile && compactHead())
+            worthwhile = (freePages() < threshold) && (deadBytes() >= area);
+    }
+    return worthwhile;
+}
+
+/*!
+    @brief Count keys stored
+    @return Number of keys
+*/
+uint16_t AT24CXXKV::count() const {
+    return _count;
+}
+
+/*!
+    @brief Count pages not holding the log
+    @return Number of free pages
+*/
+uint16_t AT24CXXKV::freePages() const {
+    return _n_pages - _used;
+}
+
+/*!
+    @brief Largest value length accepted by put()
+    @return Length in bytes
+*/
+uint8_t AT24CXXKV::maxValue() const {
+    return _page_size ? _page_size - PAGE_HEADER_SIZE - RECORD_HEADER_SIZE
+                      : 0;
+}
+
+// Private: Locate log in region and rebuild index
+bool AT24CXXKV::mount() {
+    bool result = true;
+    bool found = false;
+    uint8_t header[PAGE_HEADER_SIZE];
+    for (uint16_t page = 0; result && (page < _n_pages); page++) {
+        result = _device->read(pageAddress(page), header, PAGE_HEADER_SIZE);
+        uint32_t seq = (uint32_t)header[0] | ((uint32_t)header[1] << 8) |
+                       ((uint32_t)header[2] << 16) |
+                       ((uint32_t)header[3] << 24);
+        if (result && pageValid(header) && (!found || (seq > _seq))) {
+            found = true;
+            _seq = seq;
+            _tail = page;
+            _used = (uint16_t)(header[4] | (header[5] << 8));
+        }
+    }
+    // Empty region: no page open until the first put()
+    _fill = _page_size;
+    _flushed = _page_size;
+    if (result && !found) {
+        _head = 0;
+        _tail = _n_pages - 1;
+        _used = 0;
+        _seq = 0xFFFFFFFF;
+    } else if (result) {
+        if (_used < 1)
+            _used = 1;
+        if (_used > _n_pages)
+            _used = _n_pages;
+        _head = (uint16_t)((_tail + _n_pages - (_used - 1)) % _n_pages);
+        // Replay oldest to newest, so the latest record of each key wins
+        for (uint16_t i = 0; result && (i < _used); i++) {
+            uint16_t page = (uint16_t)((_head + i) % _n_pages);
+            uint32_t seq = _seq - (_used - 1 - i);
+            result = _device->read(pageAddress(page), _scratch, _page_size);
+            if (result && pageValid(_scratch) &&
+                (_scratch[0] == (uint8_t)seq) &&
+                (_scratch[1] == (uint8_t)(seq >> 8))) {
+                uint8_t off = PAGE_HEADER_SIZE;
+                uint8_t len = recordLength(_scratch, off, _page_size);
+                while (len) {
+                    uint16_t key = (uint16_t)(_scratch[off] |
+                                              (_scratch[off + 1] << 8));
+                    setEntry(key, pageAddress(page) + off,
+                             len - RECORD_HEADER_SIZE);
+                    off += len;
+                    len = recordLength(_scratch, off, _page_size);
+                }
+                if (page == _tail) {
+                    // Append after the last record if the rest is unwritten
+                    memcpy(_page, _scratch, _page_size);
+                    _fill = off;
+                    for (uint8_t j = off; j < _page_size; j++) {
+                        if (_page[j] != 0xFF)
+                            _fill = _page_size;
+                    }
+                    _flushed = _fill;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Private: Start next page of the log in RAM, writing out the current one
+bool AT24CXXKV::openPage() {
+    bool result = false;
+    if (writeTail() && (freePages() >= 1)) {
+        _tail = (uint16_t)((_tail + 1) % _n_pages);
+        _used++;
+        _seq++;
+        memset(_page, 0xFF, _page_size);
+        _page[0] = (uint8_t)_seq;
+        _page[1] = (uint8_t)(_seq >> 8);
+        _page[2] = (uint8_t)(_seq >> 16);
+        _page[3] = (uint8_t)(_seq >> 24);
+        _page[4] = (uint8_t)_used;
+        _page[5] = (uint8_t)(_used >> 8);
+        _page[6] = AT24CXXCrc::crc8(0, _page, 6);
+        _fill = PAGE_HEADER_SIZE;
+        _flushed = 0;
+        result = true;
+    }
+    return result;
+}
+
+// Private: Write bytes of the current page not yet on the chip
+bool AT24CXXKV::writeTail() {
+    bool result = true;
+    uint16_t address = pageAddress(_tail);
+    if (_flushed == 0) {
+        // First write of a page replaces all of its previous content
+        result = _device->write(address, _page, (size_t)_page_size);
+    } else if (_fill > _flushed) {
+        result = _device->write(address + _flushed, &_page[_flushed],
+                                (size_t)(_fill - _flushed));
+    }
+    if (result)
+        _flushed = _fill;
+    return result;
+}
+
+// Private: Reclaim oldest pages until a page may be opened with one spare
+bool AT24CXXKV::reclaim() {
+    bool result = true;
+    uint16_t attempts = _used;
+    uint8_t area = _page_size - PAGE_HEADER_SIZE;
+    while (result && (freePages() < 2)) {
+        // Without a page worth of superseded records, copying only wears;
+        // give up after one pass over the log
+        result = attempts-- && (deadBytes() >= area) && compactHead();
+    }
+    return result;
+}
+
+// Private: Copy live records of the oldest page to the log and free it
+bool AT24CXXKV::compactHead() {
+    bool result = false;
+    uint16_t page = _head;
+    if ((_used > 1) &&
+        _device->read(pageAddress(page), _scratch, _page_size)) {
+        _head = (uint16_t)((_head + 1) % _n_pages);
+        _used--;
+        result = true;
+        if (pageValid(_scratch)) {
+            uint8_t off = PAGE_HEADER_SIZE;
+            uint8_t len = recordLength(_scratch, off, _page_size);
+            while (result && len) {
+                uint16_t key = (uint16_t)(_scratch[off] |
+                                          (_scratch[off + 1] << 8));
+                int32_t i = find(key);
+                uint16_t address = pageAddress(page) + off;
+                if ((i >= 0) && (_index[i].address == address))
+                    result = append(key, &_scratch[off + RECORD_HEADER_SIZE],
+                                    len - RECORD_HEADER_SIZE);
+                off += len;
+                len = recordLength(_scratch, off, _page_size);
+            }
+        }
+    }
+    return result;
+}
+
+// Private: Add record to the current page and index it
+bool AT24CXXKV::append(uint16_t key, const uint8_t* value, uint8_t n) {
+    bool result = true;
+    if (_fill + RECORD_HEADER_SIZE + n > _page_size)
+        result = openPage();
+    if (result) {
+        uint8_t* record = &_page[_fill];
+        record[0] = (uint8_t)key;
+        record[1] = (uint8_t)(key >> 8);
+        record[2] = n;
+        memcpy(&record[RECORD_HEADER_SIZE], value, n);
+        uint8_t crc = AT24CXXCrc::crc8(_page[6], record, 3);
+        record[3] = AT24CXXCrc::crc8(crc, &record[RECORD_HEADER_SIZE], n);
+        result = setEntry(key, pageAddress(_tail) + _fill, n);
+        if (result)
+            _fill += RECORD_HEADER_SIZE + n;
+        else
+            memset(record, 0xFF, RECORD_HEADER_SIZE + n);
+    }
+    return result;
+}
+
+// Private: Point index entry of key at record, inserting in key order
+bool AT24CXXKV::setEntry(uint16_t key, uint16_t address, uint8_t n) {
+    bool result = true;
+    int32_t i = find(key);
+    if (i >= 0) {
+        _live_bytes -= RECORD_HEADER_SIZE + _index[i].length;
+    } else if (_count < _capacity) {
+        i = _count;
+        while ((i > 0) && (_index[i - 1].key > key)) {
+            _index[i] = _index[i - 1];
+            i--;
+        }
+        _count++;
+    } else {
+        result = false;
+    }
+    if (result) {
+        _index[i].key = key;
+        _index[i].address = address;
+        _index[i].length = n;
+        _live_bytes += RECORD_HEADER_SIZE + n;
+    }
+    return result;
+}
+
+// Private: Binary search of index, returns entry or -1 if absent
+int32_t AT24CXXKV::find(uint16_t key) const {
+    int32_t lo = 0;
+    int32_t hi = (int32_t)_count - 1;
+    int32_t found = -1;
+    while ((found < 0) && (lo <= hi)) {
+        int32_t mid = (lo + hi) / 2;
+        if (_index[mid].key == key)
+            found = mid;
+        else if (_index[mid].key < key)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return found;
+}
+
+// Private: Chip address of region page
+uint16_t AT24CXXKV::pageAddress(uint16_t page) const {
+    return (uint16_t)((_first_page + page) * _page_size);
+}
+
+// Private: Bytes of the log held by superseded records or unused tails
+uint32_t AT24CXXKV::deadBytes() const {
+    uint32_t area = _page_size - PAGE_HEADER_SIZE;
+    uint32_t used = (_used ? (uint32_t)(_used - 1) * area : 0);
+    if (_fill < _page_size)
+        used += _fill - PAGE_HEADER_SIZE;
+    else
+        used += area;
+    return (used > _live_bytes) ? used - _live_bytes : 0;
+}
+
+// Private: Check page header
+bool AT24CXXKV::pageValid(const uint8_t* page) {
+    bool erased = (page[0] == 0xFF) && (page[1] == 0xFF) &&
+                  (page[2] == 0xFF) && (page[3] == 0xFF);
+    return (!erased && (page[6] == AT24CXXCrc::crc8(0, page, 6)));
+}
+
+// Private: Length of valid record at offset, zero for none or damaged
+uint8_t AT24CXXKV::recordLength(const uint8_t* page, uint8_t off,
+                                uint8_t page_size) {
+    uint8_t len = 0;
+    if (off + RECORD_HEADER_SIZE <= page_size) {
+        const uint8_t* record = &page[off];
+        uint16_t key = (uint16_t)(record[0] | (record[1] << 8));
+        uint8_t n = record[2];
+        if ((key != EMPTY_KEY) &&
+            (off + RECORD_HEADER_SIZE + n <= page_size) &&
+            (record[3] ==
+             AT24CXXCrc::crc8(AT24CXXCrc::crc8(page[6], record, 3),
+                              &record[RECORD_HEADER_SIZE], n)))
+            len = RECORD_HEADER_SIZE + n;
+    }
+    return len;
+}
+
+}
@@ -0,0 +1,134 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_kv.h
+// Purpose     : AT24CXX EEPROM Log-Structured Key-Value Store Class
+// Description :
+//               This class keeps small values by 16-bit key in a reserved
+//               region of an AT24CXX chip. Rather than rewriting a fixed
+//               address, each put() appends a record to the log, so writes
+//               move around the region and wear it evenly.
+//
+//               Records collect in a RAM copy of the current log page and
+//               are written when the page fills or on flush(), so several
+//               small updates cost one write cycle. Each write programs only
+//               the bytes appended since the last, and each page and record
+//               carries a checksum, so that a write interrupted by power
+//               loss affects only the records it was writing.
+//
+//               A caller-supplied index maps each key to the address of its
+//               latest record, so get() is a single read. The index is
+//               rebuilt at begin() by replaying the log in sequence order.
+//
+//               Pages are reclaimed from the oldest end of the log by
+//               copying their live records to the newest. This is done by
+//               put() when the region runs out of free pages, and ahead of
+//               time by service() once enough of the log holds superseded
+//               records.
+//
+//               Each page holds a 7-byte header and records of a 4-byte
+//               header and the value, so values are limited to the page
+//               size less 11 bytes, e.g. 117 bytes on an AT24C512. Chips
+//               with 8-byte pages (AT24C01, AT24C02) are not supported.
+//
+//               put() refuses values once live records would fill three
+//               quarters of all but two pages. Copying grows as the region
+//               fills, so a region of about twice the live data is
+//               recommended.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_crc.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_KV_H
+#define AT24CXX_KV_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+struct AT24CXXKVEntry {
+    uint16_t key;
+    uint16_t address;
+    uint8_t length;
+};
+// Index entry locating the latest record of a key
+
+class AT24CXXKV {
+public:
+    AT24CXXKV();
+
+    bool begin(AT24CXX& device, uint16_t start, uint16_t length,
+               AT24CXXKVEntry index[], uint16_t capacity);
+    // Mount store on pages within length bytes from start on a chip
+    // initialized with begin(), replaying any existing log
+    // Parameter index provides memory for capacity distinct keys
+    // Returns false for fewer than three pages or unsupported page size
+
+    bool put(uint16_t key, const uint8_t value[], uint8_t n);
+    // Store n bytes under key, buffered until the log page fills
+    // Returns false for n above maxValue(), full index or full region
+
+    bool get(uint16_t key, uint8_t value[], uint8_t n) const;
+    // Read up to n bytes stored under key
+    // Returns false if key is absent or on failed read
+
+    uint8_t length(uint16_t key) const;
+    // Returns length of value stored under key, zero if absent
+
+    bool flush();
+    // Write buffered records to the chip
+    // Returns false for failed write
+
+    bool service();
+    // Reclaim the oldest page if enough of the log is superseded
+    // Returns true while further reclaiming is worthwhile
+
+    uint16_t count() const;
+    // Returns number of keys stored
+
+    uint16_t freePages() const;
+    // Returns number of pages not holding the log
+
+    uint8_t maxValue() const;
+    // Returns largest value length accepted by put()
+
+    static const uint8_t MAX_PAGE_SIZE = AT24CXX_MAX_PAGE_SIZE;
+
+private:
+    bool mount();
+    bool openPage();
+    bool writeTail();
+    bool reclaim();
+    bool compactHead();
+    bool append(uint16_t, const uint8_t*, uint8_t);
+    bool setEntry(uint16_t, uint16_t, uint8_t);
+    int32_t find(uint16_t) const;
+    uint16_t pageAddress(uint16_t) const;
+    uint32_t deadBytes() const;
+
+    static bool pageValid(const uint8_t*);
+    static uint8_t recordLength(const uint8_t*, uint8_t, uint8_t);
+
+    AT24CXX* _device;
+    AT24CXXKVEntry* _index;
+    uint16_t _capacity;
+    uint16_t _count;
+    uint16_t _first_page;
+    uint16_t _n_pages;
+    uint8_t _page_size;
+    uint16_t _head;
+    uint16_t _tail;
+    uint16_t _used;
+    uint32_t _seq;
+    uint8_t _fill;
+    uint8_t _flushed;
+    uint32_t _live_bytes;
+    uint8_t _page[MAX_PAGE_SIZE];
+    uint8_t _scratch[MAX_PAGE_SIZE];
+};
+
+}
+
+#endif
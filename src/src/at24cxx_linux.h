@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_linux.h
+// Purpose     : AT24CXX EEPROM Linux i2c-dev Bus Policy
+// Description :
+//               This class is a bus policy for AT24CXXStatic (see
+//               at24cxx_bus.h) using the Linux i2c-dev interface, e.g.
+//
+//                   AT24CXXStatic<AT24C512, AT24CXXLinuxBus> ee;
+//                   ee.begin(0x00, "/dev/i2c-1");
+//
+//               Each transfer is a single I2C_RDWR ioctl. A read sends the
+//               word address and the data phase as one combined transaction
+//               with repeated start, and a read of any length is issued in
+//               the same ioctl as successive read messages of up to
+//               MAX_MESSAGE bytes, which the chip serves from its internal
+//               address counter. No Wire buffer limit applies, so a whole
+//               AT24C512 is read in one system call.
+//
+//               The WP pin is not driven; pinOutput() and writePin() are
+//               no-ops and write protect should be wired or set externally.
+//               The adapter must support zero-length writes for isConnected()
+//               and ACK polling (I2C_FUNC_SMBUS_QUICK), as most do.
+//
+// Platform    : Linux
+// Language    : C++
+// Framework   : N/A
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx_bus.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_LINUX_H
+#define AT24CXX_LINUX_H
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "at24cxx_bus.h"
+
+namespace PeripheralIO {
+
+class AT24CXXLinuxBus {
+public:
+    typedef const char* Port;
+    static constexpr size_t MAX_TRANSFER = 130;
+    // Largest page (128 bytes) plus two word address bytes
+
+    static Port defaultPort() { return "/dev/i2c-1"; }
+
+    AT24CXXLinuxBus() : _fd(-1) { }
+    ~AT24CXXLinuxBus() { close(); }
+
+    void begin(Port port) {
+        close();
+        _fd = ::open(port, O_RDWR);
+    }
+
+    bool probe(uint8_t addr) {
+        return transmit(addr, nullptr, 0, nullptr, 0);
+    }
+
+    bool transmit(uint8_t addr, const uint8_t* header, uint8_t header_len,
+                  const uint8_t* data, size_t n) {
+        bool result = false;
+        if ((_fd >= 0) && (header_len + n <= MAX_TRANSFER)) {
+            uint8_t buf[MAX_TRANSFER];
+            if (header_len)
+                memcpy(buf, header, header_len);
+            if (n)
+                memcpy(&buf[header_len], data, n);
+            struct i2c_msg msg;
+            msg.addr = addr;
+            msg.flags = 0;
+            msg.len = (uint16_t)(header_len + n);
+            msg.buf = buf;
+            struct i2c_rdwr_ioctl_data xfer;
+            xfer.msgs = &msg;
+            xfer.nmsgs = 1;
+            result = (::ioctl(_fd, I2C_RDWR, &xfer) == 1);
+        }
+        return result;
+    }
+
+    bool receive(uint8_t addr, const uint8_t* header, uint8_t header_len,
+                 uint8_t* data, size_t n) {
+        bool result = false;
+        size_t n_reads = (n + MAX_MESSAGE - 1) / MAX_MESSAGE;
+        if ((_fd >= 0) && (n_reads + 1 <= I2C_RDWR_IOCTL_MAX_MSGS)) {
+            struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+            uint32_t n_msgs = 0;
+            if (header_len) {
+                msgs[n_msgs].addr = addr;
+                msgs[n_msgs].flags = 0;
+                msgs[n_msgs].len = header_len;
+                msgs[n_msgs].buf = (uint8_t*)header;
+                n_msgs++;
+            }
+            for (size_t done = 0; done < n; done += MAX_MESSAGE) {
+                msgs[n_msgs].addr = addr;
+                msgs[n_msgs].flags = I2C_M_RD;
+                msgs[n_msgs].len = (uint16_t)((n - done < MAX_MESSAGE) ?
+                                              n - done : MAX_MESSAGE);
+                msgs[n_msgs].buf = &data[done];
+                n_msgs++;
+            }
+            struct i2c_rdwr_ioctl_data xfer;
+            xfer.msgs = msgs;
+            xfer.nmsgs = n_msgs;
+            result = (::ioctl(_fd, I2C_RDWR, &xfer) == (int)n_msgs);
+        }
+        return result;
+    }
+
+    uint32_t micros() const {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+    }
+    void delayMs(uint32_t ms) const {
+        struct timespec ts;
+        ts.tv_sec = ms / 1000;
+        ts.tv_nsec = (long)(ms % 1000) * 1000000;
+        while (nanosleep(&ts, &ts) != 0) { }
+    }
+    void pinOutput(uint8_t pin) const { (void)pin; }
+    void writePin(uint8_t pin, bool high) const {
+        (void)pin;
+        (void)high;
+    }
+
+private:
+    AT24CXXLinuxBus(const AT24CXXLinuxBus&);
+    AT24CXXLinuxBus& operator=(const AT24CXXLinuxBus&);
+
+    void close() {
+        if (_fd >= 0)
+            ::close(_fd);
+        _fd = -1;
+    }
+
+    static constexpr size_t MAX_MESSAGE = 8192;
+    // Largest message accepted by i2c-dev
+
+    int _fd;
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,269 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_log.cpp
+// Purpose     : AT24CXX EEPROM Circular Append Log Class
+// Description : This source file accompanies header file at24cxx_log.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
+#include "at24cxx_log.h"
+#include "at24cxx_crc.h"
+
+namespace PeripheralIO {
+
+// Page header: sequence number (4), check (1)
+// Record slot: record, check (1), where check is never 0xFF
+const uint8_t LOG_HEADER_SIZE = 5;
+
+AT24CXXLog::AT24CXXLog()
+: _device(nullptr),
+  _first_page(0),
+  _n_pages(0),
+  _page_size(0),
+  _record_size(0),
+  _per_page(0),
+  _tail(0),
+  _full_pages(0),
+  _seq(0),
+  _fill(0),
+  _flushed(0),
+  _open(false),
+  _page()
+{ }
+
+/*!
+    @brief Mount circular log on region of AT24CXX chip
+    @param device Chip initialized with begin()
+    @param start First address of region, rounded up to a page boundary
+    @param length Length of region in bytes
+    @param record_size Size of each record in bytes
+    @return False for region too small, record too large or failed read
+*/
+bool AT24CXXLog::begin(AT24CXX& device, uint16_t start, uint32_t length,
+                       uint8_t record_size) {
+    bool result = false;
+    _device = nullptr;
+    _page_size = device.pageSize();
+    _record_size = record_size;
+    _per_page = 0;
+    if ((_page_size <= MAX_PAGE_SIZE) && record_size &&
+        (LOG_HEADER_SIZE + record_size + 1 <= _page_size)) {
+        uint32_t end = (uint32_t)start + length;
+        if (end > device.size())
+            end = device.size();
+        _first_page = (uint16_t)((start + _page_size - 1) / _page_size);
+        uint16_t last_page = (uint16_t)(end / _page_size);
+        _n_pages = (last_page > _first_page) ? last_page - _first_page : 0;
+        _per_page = (_page_size - LOG_HEADER_SIZE) / (record_size + 1);
+        _device = &device;
+        result = (_n_pages >= 2);
+    }
+    _open = false;
+    _tail = _n_pages - 1;
+    _full_pages = 0;
+    _seq = 0xFFFFFFFF;
+    uint32_t seq = 0;
+    bool found = false;
+    if (result && readHeader(0, &seq)) {
+        // Pages written in the same lap as page 0 follow on in sequence;
+        // binary search for the last of them
+        uint16_t lo = 0;
+        uint16_t hi = _n_pages;
+        while (hi - lo > 1) {
+            uint16_t mid = (uint16_t)((lo + hi) / 2);
+            uint32_t mid_seq = 0;
+            if (readHeader(mid, &mid_seq) && (mid_seq == seq + mid))
+                lo = mid;
+            else
+                hi = mid;
+        }
+        _tail = lo;
+        _seq = seq + lo;
+        found = true;
+    } else if (result && readHeader(_n_pages - 1, &seq)) {
+        // Page 0 damaged while starting a new lap
+        _tail = _n_pages - 1;
+        _seq = seq;
+        found = true;
+    }
+    if (found) {
+        // Older pages: the previous lap, possibly less one damaged page
+        _full_pages = (_tail == _n_pages - 1) ? 0 : _tail;
+        uint16_t next = (uint16_t)((_tail + 1) % _n_pages);
+        uint16_t after = (uint16_t)((_tail + 2) % _n_pages);
+        if (readHeader(next, &seq) && (seq == _seq - (_n_pages - 1)))
+            _full_pages = _n_pages - 1;
+        else if ((_n_pages > 2) && readHeader(after, &seq) &&
+                 (seq == _seq - (_n_pages - 2)))
+            _full_pages = _n_pages - 2;
+        else if (_tail == _n_pages - 1)
+            _full_pages = _n_pages - 1;
+        // Newest page: records up to the first that is damaged or unwritten
+        result = _device->read(pageAddress(_tail), _page, _page_size);
+        _fill = 0;
+        bool valid = result;
+        while (valid && (_fill < _per_page)) {
+            const uint8_t* slot =
+                &_page[LOG_HEADER_SIZE + _fill * (_record_size + 1)];
+            valid = (slot[_record_size] == slotCheck(slot, _seq));
+            if (valid)
+                _fill++;
+        }
+        _flushed = _fill;
+        _open = result;
+    }
+    if (!result)
+        _device = nullptr;
+    return result;
+}
+
+/*!
+    @brief Append record to log
+    @param record Pointer to record_size bytes
+    @return False for failed write
+*/
+bool AT24CXXLog::append(const uint8_t record[]) {
+    bool result = false;
+    if (_device) {
+        result = true;
+        if (!_open || (_fill == _per_page))
+            openPage();
+        uint8_t* slot = &_page[LOG_HEADER_SIZE + _fill * (_record_size + 1)];
+        memcpy(slot, record, _record_size);
+        slot[_record_size] = slotCheck(slot, _seq);
+        _fill++;
+        if (_fill == _per_page)
+            result = writeTail();
+    }
+    return result;
+}
+
+/*!
+    @brief Write buffered records to the chip
+    @return False for failed write
+*/
+bool AT24CXXLog::flush() {
+    return (_device && writeTail());
+}
+
+/*!
+    @brief Count records held in the log
+    @return Number of records
+*/
+uint32_t AT24CXXLog::count() const {
+    return _open ? (uint32_t)_full_pages * _per_page + _fill : 0;
+}
+
+/*!
+    @brief Read record by position from the oldest
+    @param i Position of record, zero for the oldest
+    @param record Pointer to array of record_size bytes
+    @return False for position beyond count(), damaged record or failed read
+*/
+bool AT24CXXLog::read(uint32_t i, uint8_t record[]) const {
+    bool result = false;
+    if (_device && (i < count())) {
+        uint16_t back = (uint16_t)(_full_pages - i / _per_page);
+        uint16_t page = (uint16_t)((_tail + _n_pages - back) % _n_pages);
+        uint8_t offset = LOG_HEADER_SIZE +
+                         (uint8_t)(i % _per_page) * (_record_size + 1);
+        if (page == _tail) {
+            memcpy(record, &_page[offset], _record_size);
+            result = true;
+        } else {
+            uint8_t slot[MAX_PAGE_SIZE];
+            result = _device->read(pageAddress(page) + offset, slot,
+                                   (size_t)_record_size + 1) &&
+                     (slot[_record_size] == slotCheck(slot, _seq - back));
+            if (result)
+                memcpy(record, slot, _record_size);
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Sequence number of the newest page
+    @return Sequence number, counting pages written since the log began
+*/
+uint32_t AT24CXXLog::sequence() const {
+    return _seq;
+}
+
+// Private: Read sequence number of page, returns false if not valid
+bool AT24CXXLog::readHeader(uint16_t page, uint32_t* seq) const {
+    uint8_t header[LOG_HEADER_SIZE];
+    bool result = _device->read(pageAddress(page), header, LOG_HEADER_SIZE);
+    if (result) {
+        *seq = (uint32_t)header[0] | ((uint32_t)header[1] << 8) |
+               ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 24);
+        result = (*seq != 0xFFFFFFFF) && (header[4] == headerCheck(*seq));
+    }
+    return result;
+}
+
+// Private: Write records of the newest page not yet on the chip
+bool AT24CXXLog::writeTail() {
+    bool result = true;
+    uint16_t address = pageAddress(_tail);
+    uint8_t slot_size = _record_size + 1;
+    if (_open && (_flushed == 0) && _fill) {
+        // First write of a page replaces all of its previous content
+        result = _device->write(address, _page, (size_t)_page_size);
+    } else if (_open && (_fill > _flushed)) {
+        uint8_t offset = LOG_HEADER_SIZE + _flushed * slot_size;
+        result = _device->write(address + offset, &_page[offset],
+                                (size_t)(_fill - _flushed) * slot_size);
+    }
+    if (result)
+        _flushed = _fill;
+    return result;
+}
+
+// Private: Start next page in RAM, replacing the oldest once full
+void AT24CXXLog::openPage() {
+    if (_open && (_full_pages < _n_pages - 1))
+        _full_pages++;
+    _tail = (uint16_t)((_tail + 1) % _n_pages);
+    _seq++;
+    memset(_page, 0xFF, _page_size);
+    _page[0] = (uint8_t)_seq;
+    _page[1] = (uint8_t)(_seq >> 8);
+    _page[2] = (uint8_t)(_seq >> 16);
+    _page[3] = (uint8_t)(_seq >> 24);
+    _page[4] = headerCheck(_seq);
+    _fill = 0;
+    _flushed = 0;
+    _open = true;
+}
+
+// Private: Chip address of region page
+uint16_t AT24CXXLog::pageAddress(uint16_t page) const {
+    return (uint16_t)((_first_page + page) * _page_size);
+}
+
+// Private: Check byte of record in page seq, never 0xFF as when unwritten
+uint8_t AT24CXXLog::slotCheck(const uint8_t* record, uint32_t seq) const {
+    uint8_t check = AT24CXXCrc::crc8(headerCheck(seq), record, _record_size);
+    return (check == 0xFF) ? 0xFE : check;
+}
+
+// Private: Check byte of page header
+uint8_t AT24CXXLog::headerCheck(uint32_t seq) {
+    uint8_t bytes[4] = {
+        (uint8_t)seq, (uint8_t)(seq >> 8),
+        (uint8_t)(seq >> 16), (uint8_t)(seq >> 24)
+    };
+    return AT24CXXCrc::crc8(0, bytes, 4);
+}
+
+}
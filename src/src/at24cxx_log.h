@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_log.h
+// Purpose     : AT24CXX EEPROM Circular Append Log Class
+// Description :
+//               This class keeps a ring of fixed-size records, e.g. events,
+//               in a reserved region of an AT24CXX chip. Once the region is
+//               full, each new page of records replaces the oldest.
+//
+//               Records collect in a RAM copy of the newest page and are
+//               written when the page fills or on flush(), so that a page of
+//               records costs one write cycle. Each write programs only the
+//               bytes appended since the last.
+//
+//               Every page begins with a sequence number one greater than
+//               that of the page before it. Around the ring, sequence
+//               numbers therefore rise up to the newest page and drop after
+//               it, so begin() finds the newest page by binary search over
+//               page headers, e.g. 12 header reads and one page read for
+//               the 512 pages of an AT24C512, rather than a scan of the
+//               whole region.
+//
+//               Page headers and records carry checksums, so that a write
+//               interrupted by power loss costs only the records it was
+//               writing. Records not yet written by flush() are lost on
+//               power loss.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_crc.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_LOG_H
+#define AT24CXX_LOG_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXLog {
+public:
+    AT24CXXLog();
+
+    bool begin(AT24CXX& device, uint16_t start, uint32_t length,
+               uint8_t record_size);
+    // Mount log on pages within length bytes from start on a chip
+    // initialized with begin(), recovering any existing records
+    // Returns false for fewer than two pages, records that do not fit a
+    // page, or failed read
+
+    bool append(const uint8_t record[]);
+    // Add record of record_size bytes, buffered until the page fills
+    // Returns false for failed write
+
+    bool flush();
+    // Write buffered records to the chip
+    // Returns false for failed write
+
+    uint32_t count() const;
+    // Returns number of records held, oldest first
+
+    bool read(uint32_t i, uint8_t record[]) const;
+    // Read record i, counting from the oldest held
+    // Returns false for i beyond count(), damaged record or failed read
+
+    uint32_t sequence() const;
+    // Returns sequence number of the newest page
+
+    static const uint8_t MAX_PAGE_SIZE = AT24CXX_MAX_PAGE_SIZE;
+
+private:
+    bool readHeader(uint16_t, uint32_t*) const;
+    bool writeTail();
+    void openPage();
+    uint16_t pageAddress(uint16_t) const;
+    uint8_t slotCheck(const uint8_t*, uint32_t) const;
+
+    static uint8_t headerCheck(uint32_t);
+
+    AT24CXX* _device;
+    uint16_t _first_page;
+    uint16_t _n_pages;
+    uint8_t _page_size;
+    uint8_t _record_size;
+    uint8_t _per_page;
+    uint16_t _tail;
+    uint16_t _full_pages;
+    uint32_t _seq;
+    uint8_t _fill;
+    uint8_t _flushed;
+    bool _open;
+    uint8_t _page[MAX_PAGE_SIZE];
+};
+
+}
+
+#endif
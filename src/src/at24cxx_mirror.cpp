@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_mirror.cpp
+// Purpose     : AT24CXX EEPROM Mirrored Volume Class
+// Description : This source file accompanies header file at24cxx_mirror.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
+#include "at24cxx_mirror.h"
+
+namespace PeripheralIO {
+
+AT24CXXMirror::AT24CXXMirror()
+: _devices(),
+  _next_read(0),
+  _pending(false),
+  _success(false),
+  _callback(nullptr),
+  _context(nullptr)
+{ }
+
+/*!
+    @brief Pair two chips as a mirrored volume
+    @param primary Chip holding the reference copy
+    @param secondary Chip holding the mirror copy
+*/
+void AT24CXXMirror::begin(AT24CXX& primary, AT24CXX& secondary) {
+    _devices[0] = &primary;
+    _devices[1] = &secondary;
+}
+
+/*!
+    @brief Size of the mirrored volume
+    @return Size in bytes
+*/
+uint32_t AT24CXXMirror::size() const {
+    uint32_t total = 0;
+    if (_devices[0]) {
+        total = _devices[0]->size();
+        if (_devices[1]->size() < total)
+            total = _devices[1]->size();
+    }
+    return total;
+}
+
+/*!
+    @brief Write n bytes to both chips from vals
+    @param address Address to write bytes
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+bool AT24CXXMirror::write(uint16_t address, const uint8_t vals[], size_t n) {
+    bool result = writeAsync(address, vals, n);
+    if (result) {
+        while (service()) { }
+        result = _success;
+    }
+    return result;
+}
+
+/*!
+    @brief Submit n bytes for non-blocking write to both chips
+    @param address Address to write bytes
+    @param vals Pointer to bytes, must remain valid until completion
+    @param n Number of successive bytes to write
+    @param callback Function called on completion, may be nullptr
+    @param context Pointer passed through to callback
+    @return False for rejected write (e.g. busy or invalid memory regions)
+*/
+bool AT24CXXMirror::writeAsync(uint16_t address, const uint8_t vals[],
+                               size_t n, AT24CXXCallback callback,
+                               void* context) {
+    bool result = false;
+    if (_devices[0] && !_pending && ((uint32_t)(address + n) <= size())) {
+        _success = true;
+        _callback = callback;
+        _context = context;
+        for (uint8_t i = 0; i < 2; i++) {
+            if (!_devices[i]->writeAsync(address, vals, n, onWriteDone,
+                                         &_success))
+                _success = false;
+        }
+        _pending = true;
+        result = true;
+    }
+    return result;
+}
+
+/*!
+    @brief Advance pending non-blocking write on both chips
+    @return True while the write remains pending on either chip
+*/
+bool AT24CXXMirror::service() {
+    if (_pending) {
+        bool busy = _devices[0]->service();
+        if (_devices[1]->service())
+            busy = true;
+        if (!busy) {
+            _pending = false;
+            if (_callback)
+                _callback(_success, _context);
+        }
+    }
+    return _pending;
+}
+
+/*!
+    @brief Read n bytes from an available chip
+    @param address Address to read bytes
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for failed to read from both chips
+*/
+bool AT24CXXMirror::read(uint16_t address, uint8_t vals[], size_t n) {
+    bool result = false;
+    if (_devices[0]) {
+        // Wait only while both chips are busy with a pending write
+        while (_devices[0]->isWriteBusy() && _devices[1]->isWriteBusy())
+            service();
+        uint8_t first = _next_read;
+        if (_devices[first]->isWriteBusy())
+            first ^= 1;
+        _next_read = first ^ 1;
+        result = _devices[first]->read(address, vals, n);
+        if (!result) {
+            while (_devices[first ^ 1]->isWriteBusy())
+                service();
+            result = _devices[first ^ 1]->read(address, vals, n);
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Copy differing pages from primary chip to secondary chip
+    @return False for failed read or write
+*/
+bool AT24CXXMirror::resync() {
+    bool result = false;
+    if (_devices[0] && !_pending) {
+        uint8_t page_size = _devices[0]->pageSize();
+        uint8_t ref[AT24CXX_MAX_PAGE_SIZE];
+        uint8_t copy[AT24CXX_MAX_PAGE_SIZE];
+        uint32_t total = size();
+        result = true;
+        for (uint32_t address = 0; result && (address < total);
+             address += page_size) {
+            result = _devices[0]->read((uint16_t)address, ref, page_size) &&
+                     _devices[1]->read((uint16_t)address, copy, page_size);
+            if (result && memcmp(ref, copy, page_size))
+                result = _devices[1]->write((uint16_t)address, ref,
+                                            page_size);
+        }
+    }
+    return result;
+}
+
+// Private: Completion callback recording failure on either chip
+void AT24CXXMirror::onWriteDone(bool success, void* context) {
+    if (!success)
+        *(bool*)context = false;
+}
+
+}
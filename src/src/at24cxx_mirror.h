@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_mirror.h
+// Purpose     : AT24CXX EEPROM Mirrored Volume Class
+// Description :
+//               This class keeps identical copies of data on two AT24CXX
+//               chips. Writes are dispatched to both chips through their
+//               non-blocking write engines, so that the two write cycles
+//               overlap rather than adding. Reads alternate between the
+//               chips, favoring whichever is not busy with a write, and
+//               fall back to the other chip if one fails to respond.
+//
+//               A write may proceed in the background with writeAsync() and
+//               service(); reads issued meanwhile are served by a chip that
+//               has already finished, waiting only if neither has.
+//
+//               resync() restores the secondary chip from the primary, e.g.
+//               after replacing a chip or after a failed write.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_MIRROR_H
+#define AT24CXX_MIRROR_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXMirror {
+public:
+    AT24CXXMirror();
+
+    void begin(AT24CXX& primary, AT24CXX& secondary);
+    // Pair two chips initialized with begin()
+
+    uint32_t size() const;
+    // Returns size of the mirrored volume in bytes
+
+    bool write(uint16_t address, const uint8_t vals[], size_t n);
+    // Write n successive values to address on both chips
+    // Returns false for invalid memory regions or failed write on either
+
+    bool writeAsync(uint16_t address, const uint8_t vals[], size_t n,
+                    AT24CXXCallback callback=nullptr, void* context=nullptr);
+    // Submit n successive values for non-blocking write to both chips
+    // Buffer vals must remain valid until the write completes
+    // Returns false if a write is already pending or for invalid regions
+
+    bool service();
+    // Advance a pending non-blocking write; call repeatedly from loop()
+    // Returns true while the write remains pending
+
+    bool read(uint16_t address, uint8_t vals[], size_t n);
+    // Read n successive values from address on an available chip
+    // Returns false if neither chip could be read
+
+    bool resync();
+    // Copy pages of the primary chip that differ onto the secondary
+    // Returns false for failed read or write
+
+private:
+    static void onWriteDone(bool, void*);
+
+    AT24CXX* _devices[2];
+    uint8_t _next_read;
+    bool _pending;
+    bool _success;
+    AT24CXXCallback _callback;
+    void* _context;
+};
+
+}
+
+#endif
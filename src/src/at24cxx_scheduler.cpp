@@ -0,0 +1,112 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_scheduler.cpp
+// Purpose     : AT24CXX EEPROM Multi-Device Write Scheduler
+// Description : This source file accompanies header file at24cxx_scheduler.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include "at24cxx_scheduler.h"
+
+namespace PeripheralIO {
+
+AT24CXXScheduler::AT24CXXScheduler()
+: _jobs(),
+  _n_jobs(0)
+{ }
+
+/*!
+    @brief Queue n bytes for write to AT24CXX device
+    @param device Chip to write, initialized with begin()
+    @param address Address to write bytes
+    @param vals Pointer to bytes, must remain valid until completion
+    @param n Number of successive bytes to write
+    @param callback Function called on completion, may be nullptr
+    @param context Pointer passed through to callback
+    @return False for full queue
+*/
+bool AT24CXXScheduler::submit(AT24CXX& device, uint16_t address,
+                              const uint8_t vals[], size_t n,
+                              AT24CXXCallback callback, void* context) {
+    bool result = false;
+    if (_n_jobs < MAX_JOBS) {
+        Job& job = _jobs[_n_jobs++];
+        job.device = &device;
+        job.address = address;
+        job.vals = vals;
+        job.n = n;
+        job.callback = callback;
+        job.context = context;
+        job.active = false;
+        result = true;
+    }
+    return result;
+}
+
+/*!
+    @brief Advance each chip with queued writes by one step
+    @return True while any write remains queued
+*/
+bool AT24CXXScheduler::service() {
+    AT24CXX* serviced[MAX_JOBS];
+    uint8_t n_serviced = 0;
+    uint8_t i = 0;
+    while (i < _n_jobs) {
+        Job& job = _jobs[i];
+        bool first = true;
+        for (uint8_t k = 0; first && (k < n_serviced); k++)
+            first = (serviced[k] != job.device);
+        bool done = false;
+        if (first) {
+            // Only the oldest job for each chip may run
+            serviced[n_serviced++] = job.device;
+            if (!job.active) {
+                job.active = job.device->writeAsync(job.address, job.vals,
+                                                    job.n, job.callback,
+                                                    job.context);
+                if (!job.active && job.callback)
+                    job.callback(false, job.context);
+                done = !job.active;
+            }
+            if (job.active)
+                done = !job.device->service();
+        }
+        if (done)
+            remove(i);
+        else
+            i++;
+    }
+    return (_n_jobs > 0);
+}
+
+/*!
+    @brief Block until all queued writes have completed
+*/
+void AT24CXXScheduler::flush() {
+    while (service()) { }
+}
+
+/*!
+    @brief Count queued writes
+    @return Number of writes queued or in progress
+*/
+uint8_t AT24CXXScheduler::pending() const {
+    return _n_jobs;
+}
+
+// Private: Remove job, preserving submission order of the remainder
+void AT24CXXScheduler::remove(uint8_t index) {
+    for (uint8_t i = index; i + 1 < _n_jobs; i++)
+        _jobs[i] = _jobs[i + 1];
+    _n_jobs--;
+}
+
+}
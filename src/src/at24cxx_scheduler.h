@@ -0,0 +1,73 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_scheduler.h
+// Purpose     : AT24CXX EEPROM Multi-Device Write Scheduler
+// Description :
+//               This class interleaves non-blocking writes to several
+//               AT24CXX chips sharing a TwoWire bus. Writes are queued with
+//               submit() and each call to service() advances every chip
+//               with a queued write by one step, so that while one chip is
+//               in its internal write cycle the bus is used to program the
+//               next. Writes to the same chip are performed in submission
+//               order, one at a time.
+//
+//               Chips must have been initialized with begin(), and their
+//               completion mode (fixed delay or ACK polling) is respected.
+//               With the fixed delay, a waiting chip costs no bus traffic.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_SCHEDULER_H
+#define AT24CXX_SCHEDULER_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXScheduler {
+public:
+    AT24CXXScheduler();
+
+    bool submit(AT24CXX& device, uint16_t address, const uint8_t vals[],
+                size_t n, AT24CXXCallback callback=nullptr,
+                void* context=nullptr);
+    // Queue n successive values for write to address on device
+    // Buffer vals must remain valid until the write completes
+    // Returns false when the queue is full
+
+    bool service();
+    // Advance each chip with queued writes by one step
+    // Returns true while any write remains queued
+
+    void flush();
+    // Block until all queued writes have completed
+
+    uint8_t pending() const;
+    // Returns number of queued writes, including those in progress
+
+    static const uint8_t MAX_JOBS = 16;
+
+private:
+    struct Job {
+        AT24CXX* device;
+        uint16_t address;
+        const uint8_t* vals;
+        size_t n;
+        AT24CXXCallback callback;
+        void* context;
+        bool active;
+    };
+
+    void remove(uint8_t);
+
+    Job _jobs[MAX_JOBS];
+    uint8_t _n_jobs;
+};
+
+}
+
+#endif
@@ -0,0 +1,222 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_shadow.cpp
+// Purpose     : AT24CXX EEPROM Atomic Shadow Slot Class
+// Description : This source file accompanies header file at24cxx_shadow.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
+#include "at24cxx_shadow.h"
+#include "at24cxx_crc.h"
+
+namespace PeripheralIO {
+
+// Header entry per slot: generation (4), length (2), payload CRC-32 (4),
+// check (1)
+const uint8_t SHADOW_ENTRY_SIZE = 11;
+// Bytes read per transfer when checking a slot's payload
+const uint8_t SHADOW_CHUNK = 32;
+
+AT24CXXShadow::AT24CXXShadow()
+: _device(nullptr),
+  _header(0),
+  _header_size(0),
+  _capacity(0),
+  _slot_size(0),
+  _active(0),
+  _generation(0),
+  _length(0)
+{ }
+
+/*!
+    @brief Mount shadow slots on region of AT24CXX chip
+    @param device Chip initialized with begin()
+    @param start First address of region, rounded up to a page boundary
+    @param capacity Largest number of bytes to be committed
+    @return False for region beyond the chip or failed read
+*/
+bool AT24CXXShadow::begin(AT24CXX& device, uint16_t start,
+                          uint16_t capacity) {
+    uint8_t page_size = device.pageSize();
+    uint32_t header = ((uint32_t)start + page_size - 1) / page_size *
+                      page_size;
+    _device = nullptr;
+    _header = (uint16_t)header;
+    // Each entry on pages of its own, so that no page write spans both
+    _header_size = (uint16_t)(2 * ((SHADOW_ENTRY_SIZE + page_size - 1) /
+                                   page_size * page_size));
+    _capacity = capacity;
+    _slot_size = (uint16_t)(((uint32_t)capacity + page_size - 1) /
+                            page_size * page_size);
+    _active = 0;
+    _generation = 0;
+    _length = 0;
+    bool result = capacity && (header + regionSize() <= device.size());
+    if (result) {
+        _device = &device;
+        result = readEntries();
+    }
+    if (!result)
+        _device = nullptr;
+    return result;
+}
+
+/*!
+    @brief Replace contents of shadow slots atomically
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to commit
+    @return False for n above capacity or failed write
+*/
+bool AT24CXXShadow::commit(const uint8_t vals[], uint16_t n) {
+    bool result = false;
+    if (_device && (n <= _capacity)) {
+        // Slot data first; the header entry makes it current
+        uint8_t slot = _generation ? _active ^ 1 : 0;
+        uint32_t generation = _generation + 1;
+        uint32_t crc = AT24CXXCrc::crc32(0, vals, n);
+        uint8_t entry[SHADOW_ENTRY_SIZE];
+        entry[0] = (uint8_t)generation;
+        entry[1] = (uint8_t)(generation >> 8);
+        entry[2] = (uint8_t)(generation >> 16);
+        entry[3] = (uint8_t)(generation >> 24);
+        entry[4] = (uint8_t)n;
+        entry[5] = (uint8_t)(n >> 8);
+        entry[6] = (uint8_t)crc;
+        entry[7] = (uint8_t)(crc >> 8);
+        entry[8] = (uint8_t)(crc >> 16);
+        entry[9] = (uint8_t)(crc >> 24);
+        entry[10] = AT24CXXCrc::crc8(slot, entry, SHADOW_ENTRY_SIZE - 1);
+        result = (!n || _device->write(slotAddress(slot), vals, n)) &&
+                 _device->write(entryAddress(slot), entry,
+                                SHADOW_ENTRY_SIZE);
+        if (result) {
+            _active = slot;
+            _generation = generation;
+            _length = n;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Read committed bytes from the active slot
+    @param offset Position within the contents to read from
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for span beyond committed length or failed read
+*/
+bool AT24CXXShadow::read(uint16_t offset, uint8_t vals[], uint16_t n) const {
+    return _device && ((uint32_t)offset + n <= _length) &&
+           (!n || _device->read(slotAddress(_active) + offset, vals, n));
+}
+
+/*!
+    @brief Length of committed contents
+    @return Number of bytes, zero if none committed
+*/
+uint16_t AT24CXXShadow::length() const {
+    return _length;
+}
+
+/*!
+    @brief Capacity of each slot
+    @return Largest number of bytes accepted by commit()
+*/
+uint16_t AT24CXXShadow::capacity() const {
+    return _capacity;
+}
+
+/*!
+    @brief Generation of committed contents
+    @return Number of the latest commit, zero if none
+*/
+uint32_t AT24CXXShadow::generation() const {
+    return _generation;
+}
+
+/*!
+    @brief Size of region used by header and both slots
+    @return Size in bytes from the page boundary at or after start
+*/
+uint32_t AT24CXXShadow::regionSize() const {
+    return (uint32_t)_header_size + 2 * (uint32_t)_slot_size;
+}
+
+// Private: Select the newest slot whose entry and payload are both intact
+bool AT24CXXShadow::readEntries() {
+    uint32_t generations[2] = { 0, 0 };
+    uint16_t lengths[2] = { 0, 0 };
+    uint32_t crcs[2] = { 0, 0 };
+    bool result = true;
+    for (uint8_t slot = 0; result && (slot < 2); slot++) {
+        uint8_t entry[SHADOW_ENTRY_SIZE];
+        result = _device->read(entryAddress(slot), entry, SHADOW_ENTRY_SIZE);
+        uint32_t generation = (uint32_t)entry[0] |
+                              ((uint32_t)entry[1] << 8) |
+                              ((uint32_t)entry[2] << 16) |
+                              ((uint32_t)entry[3] << 24);
+        uint16_t length = (uint16_t)(entry[4] | (entry[5] << 8));
+        if (result && (generation != 0xFFFFFFFF) &&
+            (length <= _capacity) &&
+            (entry[10] ==
+             AT24CXXCrc::crc8(slot, entry, SHADOW_ENTRY_SIZE - 1))) {
+            generations[slot] = generation;
+            lengths[slot] = length;
+            crcs[slot] = (uint32_t)entry[6] | ((uint32_t)entry[7] << 8) |
+                         ((uint32_t)entry[8] << 16) |
+                         ((uint32_t)entry[9] << 24);
+        }
+    }
+    // Newest first, falling back to the other slot if its payload is bad
+    uint8_t newest = (generations[1] > generations[0]) ? 1 : 0;
+    for (uint8_t i = 0; result && (i < 2) && !_generation; i++) {
+        uint8_t slot = newest ^ i;
+        uint32_t crc = 0;
+        if (generations[slot]) {
+            result = payloadCrc(slot, lengths[slot], &crc);
+            if (result && (crc == crcs[slot])) {
+                _active = slot;
+                _generation = generations[slot];
+                _length = lengths[slot];
+            }
+        }
+    }
+    return result;
+}
+
+// Private: CRC-32 of the first n bytes of a slot, read in short chunks
+bool AT24CXXShadow::payloadCrc(uint8_t slot, uint16_t n,
+                               uint32_t* crc) const {
+    uint8_t chunk[SHADOW_CHUNK];
+    uint16_t done = 0;
+    bool result = true;
+    *crc = 0;
+    while (result && (done < n)) {
+        uint16_t len = (n - done < SHADOW_CHUNK) ? n - done : SHADOW_CHUNK;
+        result = _device->read(slotAddress(slot) + done, chunk, len);
+        *crc = AT24CXXCrc::crc32(*crc, chunk, len);
+        done += len;
+    }
+    return result;
+}
+
+// Private: Chip address of the header entry of slot A (0) or B (1)
+uint16_t AT24CXXShadow::entryAddress(uint8_t slot) const {
+    return (uint16_t)(_header + slot * (_header_size / 2));
+}
+
+// Private: Chip address of slot A (0) or B (1)
+uint16_t AT24CXXShadow::slotAddress(uint8_t slot) const {
+    return (uint16_t)(_header + _header_size + slot * _slot_size);
+}
+
+}
@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_shadow.h
+// Purpose     : AT24CXX EEPROM Atomic Shadow Slot Class
+// Description :
+//               This class keeps a block of data, e.g. a configuration
+//               struct spanning several pages, in a reserved region of an
+//               AT24CXX chip such that an update either completes or leaves
+//               the previous contents intact, even if interrupted by reset
+//               or power loss.
+//
+//               The region holds a header and two slots, A and B. commit()
+//               writes the new data to whichever slot is not active, then
+//               writes a small header entry for that slot holding a
+//               generation number one greater than the active slot's and a
+//               CRC-32 of the data. Until that entry is written, the
+//               previous slot remains the newest valid one; an entry torn
+//               by power loss fails its checksum and is ignored. An update
+//               therefore costs one header write on top of the data, rather
+//               than a second full copy.
+//
+//               Each header entry and each slot starts on a page boundary
+//               of its own, so that a page write to one never touches
+//               another, including on chips with 8-byte pages.
+//
+//               begin() reads both header entries and selects the valid one
+//               with the greater generation whose slot data still matches
+//               its CRC-32, falling back to the other slot if it does not.
+//               Boot therefore costs two short reads and one pass over the
+//               active slot's data.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_crc.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_SHADOW_H
+#define AT24CXX_SHADOW_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXShadow {
+public:
+    AT24CXXShadow();
+
+    bool begin(AT24CXX& device, uint16_t start, uint16_t capacity);
+    // Mount shadow slots of capacity bytes each from start on a chip
+    // initialized with begin(), selecting the newest committed slot
+    // Returns false for region beyond the chip or failed read
+
+    bool commit(const uint8_t vals[], uint16_t n);
+    // Replace contents with n bytes, atomically with respect to power loss
+    // Returns false for n above capacity() or failed write, in which case
+    // the previous contents remain
+
+    bool read(uint16_t offset, uint8_t vals[], uint16_t n) const;
+    // Read n committed bytes from offset within the contents
+    // Returns false for span beyond length() or failed read
+
+    uint16_t length() const;
+    // Returns number of bytes committed, zero if none
+
+    uint16_t capacity() const;
+    // Returns largest number of bytes accepted by commit()
+
+    uint32_t generation() const;
+    // Returns number of the latest commit, zero if none
+
+    uint32_t regionSize() const;
+    // Returns bytes of chip used by header and slots from start
+
+private:
+    bool readEntries();
+    bool payloadCrc(uint8_t, uint16_t, uint32_t*) const;
+    uint16_t entryAddress(uint8_t) const;
+    uint16_t slotAddress(uint8_t) const;
+
+
+    AT24CXX* _device;
+    uint16_t _header;
+    uint16_t _header_size;
+    uint16_t _capacity;
+    uint16_t _slot_size;
+    uint8_t _active;
+    uint32_t _generation;
+    uint16_t _length;
+};
+
+}
+
+#endif
@@ -0,0 +1,397 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_sim.cpp
+// Purpose     : AT24CXX EEPROM Host Simulator
+// Description : This source file accompanies header file at24cxx_sim.h
+// Platform    : Host (Linux, macOS)
+// Framework   : N/A
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifndef ARDUINO
+
+#include <string.h>
+#include "at24cxx_sim.h"
+
+namespace {
+
+uint64_t clock_ns = 0;
+uint8_t pin_levels[256] = {};
+
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    pin_levels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin_levels[pin];
+}
+
+// Reading the clock costs time, so that busy-wait loops terminate
+unsigned long millis() {
+    clock_ns += 1000;
+    return (unsigned long)(clock_ns / 1000000);
+}
+
+unsigned long micros() {
+    clock_ns += 1000;
+    return (unsigned long)(clock_ns / 1000);
+}
+
+void delay(uint32_t ms) {
+    clock_ns += (uint64_t)ms * 1000000;
+}
+
+void delayMicroseconds(uint32_t us) {
+    clock_ns += (uint64_t)us * 1000;
+}
+
+TwoWire Wire;
+TwoWire Wire1;
+
+TwoWire::TwoWire()
+: _chips(),
+  _n_chips(0),
+  _frequency(100000),
+  _overhead_ns(0),
+  _transactions(0),
+  _bytes(0),
+  _nacks(0),
+  _bus_ns(0),
+  _last_addr(0),
+  _tx_addr(0),
+  _tx_buf(),
+  _tx_len(0),
+  _rx_buf(),
+  _rx_len(0),
+  _rx_pos(0)
+{ }
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    if (frequency)
+        _frequency = frequency;
+    return true;
+}
+
+void TwoWire::setClock(uint32_t frequency) {
+    _frequency = frequency;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _tx_addr = address;
+    _tx_len = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    size_t written = 0;
+    if (_tx_len < I2C_BUFFER_LENGTH) {
+        _tx_buf[_tx_len++] = data;
+        written = 1;
+    }
+    return written;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t n) {
+    size_t written = 0;
+    while ((written < n) && write(data[written]))
+        written++;
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool send_stop) {
+    uint8_t status = 2; // Address NACK
+    uint32_t n_bytes = 1;
+    PeripheralIO::AT24CXXSim* chip = findChip(_tx_addr);
+    int acked = chip ? chip->writeBytes(_tx_addr, _tx_buf, _tx_len) : -1;
+    _last_addr = _tx_addr;
+    if (acked == (int)_tx_len) {
+        status = 0;
+        n_bytes = (uint32_t)_tx_len + 1;
+    } else if (acked >= 0) {
+        status = 3; // Data NACK, master stops after the refused byte
+        n_bytes = (uint32_t)acked + 2;
+    }
+    if (status)
+        _nacks++;
+    clockTransfer(n_bytes, send_stop || status);
+    _tx_len = 0;
+    return status;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t n, bool send_stop) {
+    _rx_len = 0;
+    _rx_pos = 0;
+    if (n > I2C_BUFFER_LENGTH)
+        n = I2C_BUFFER_LENGTH;
+    PeripheralIO::AT24CXXSim* chip = findChip(address);
+    if (chip)
+        _rx_len = chip->readBytes(address, _rx_buf, n);
+    _last_addr = address;
+    if (!_rx_len)
+        _nacks++;
+    clockTransfer((uint32_t)_rx_len + 1, send_stop || !_rx_len);
+    return (uint8_t)_rx_len;
+}
+
+int TwoWire::available() {
+    return (int)(_rx_len - _rx_pos);
+}
+
+int TwoWire::read() {
+    int val = -1;
+    if (_rx_pos < _rx_len)
+        val = _rx_buf[_rx_pos++];
+    return val;
+}
+
+size_t TwoWire::readBytes(uint8_t* buffer, size_t length) {
+    size_t n_read = 0;
+    while ((n_read < length) && (_rx_pos < _rx_len))
+        buffer[n_read++] = _rx_buf[_rx_pos++];
+    return n_read;
+}
+
+void TwoWire::attach(PeripheralIO::AT24CXXSim* chip) {
+    if (_n_chips < MAX_CHIPS)
+        _chips[_n_chips++] = chip;
+}
+
+void TwoWire::setTransactionOverhead(uint32_t ns) {
+    _overhead_ns = ns;
+}
+
+uint32_t TwoWire::transactions() const {
+    return _transactions;
+}
+
+uint32_t TwoWire::bytesTransferred() const {
+    return _bytes;
+}
+
+uint32_t TwoWire::nacks() const {
+    return _nacks;
+}
+
+uint64_t TwoWire::busTimeNs() const {
+    return _bus_ns;
+}
+
+uint8_t TwoWire::lastAddress() const {
+    return _last_addr;
+}
+
+void TwoWire::resetStats() {
+    _transactions = 0;
+    _bytes = 0;
+    _nacks = 0;
+    _bus_ns = 0;
+}
+
+void TwoWire::detach(PeripheralIO::AT24CXXSim* chip) {
+    uint8_t j = 0;
+    for (uint8_t i = 0; i < _n_chips; i++) {
+        if (_chips[i] != chip)
+            _chips[j++] = _chips[i];
+    }
+    _n_chips = j;
+}
+
+PeripheralIO::AT24CXXSim* TwoWire::findChip(uint8_t address) const {
+    PeripheralIO::AT24CXXSim* chip = nullptr;
+    for (uint8_t i = 0; !chip && (i < _n_chips); i++) {
+        if (_chips[i]->matches(address))
+            chip = _chips[i];
+    }
+    return chip;
+}
+
+// Private: Advance clock by START, n bytes with ACK bits, optional STOP
+void TwoWire::clockTransfer(uint32_t n_bytes, bool send_stop) {
+    uint32_t bits = 1 + 9 * n_bytes + (send_stop ? 1 : 0);
+    uint64_t ns = ((uint64_t)bits * 1000000000) / _frequency + _overhead_ns;
+    clock_ns += ns;
+    _bus_ns += ns;
+    _bytes += n_bytes;
+    _transactions++;
+}
+
+namespace PeripheralIO {
+
+uint64_t simClockNs() {
+    return clock_ns;
+}
+
+void simClockAdvance(uint64_t ns) {
+    clock_ns += ns;
+}
+
+AT24CXXSim::AT24CXXSim(uint32_t chip, uint8_t chip_addr, TwoWire& wire)
+: _mem(nullptr),
+  _wire(&wire),
+  _chip_addr(0x50 | (chip_addr & 0x07)),
+  _chip_size(chip & 0x0001FFFF),
+  _page_size((uint8_t)((chip & 0x0FF00000) >> 20)),
+  _addr_bytes((uint8_t)((chip & 0x30000000) >> 28)),
+  _addr_ov_bits((uint8_t)((chip & 0xC0000000) >> 30)),
+  _wp_pin(0xFF),
+  _block_wrap(false),
+  _pointer(0),
+  _busy_until_ns(0),
+  _cycle_min_us(1500),
+  _cycle_max_us(3000),
+  _rand_state(0x2545F491u ^ chip_addr),
+  _write_cycles(0)
+{
+    _mem = new uint8_t[_chip_size];
+    memset(_mem, 0xFF, _chip_size);
+    wire.attach(this);
+}
+
+AT24CXXSim::~AT24CXXSim() {
+    _wire->detach(this);
+    delete[] _mem;
+}
+
+/*!
+    @brief Set range of simulated internal write cycle time
+    @param min_us Shortest write cycle time
+    @param max_us Longest write cycle time
+*/
+void AT24CXXSim::setWriteCycle(uint32_t min_us, uint32_t max_us) {
+    _cycle_min_us = min_us;
+    _cycle_max_us = (max_us < min_us) ? min_us : max_us;
+}
+
+/*!
+    @brief Honor write protect input driven on a simulated pin
+    @param pin Pin connected to WP
+*/
+void AT24CXXSim::setWriteProtectPin(uint8_t pin) {
+    _wp_pin = pin;
+}
+
+/*!
+    @brief Wrap sequential reads at the end of each 256-byte block
+    @param wrap True to wrap within the block, false to continue through
+*/
+void AT24CXXSim::setBlockReadWrap(bool wrap) {
+    _block_wrap = wrap;
+}
+
+/*!
+    @brief Check whether chip responds to device address
+    @param address 7-bit device address
+    @return True if address selects this chip
+*/
+bool AT24CXXSim::matches(uint8_t address) const {
+    uint8_t mask = (uint8_t)~((1 << _addr_ov_bits) - 1);
+    return ((address & mask) == (_chip_addr & mask));
+}
+
+/*!
+    @brief Check whether chip is in its internal write cycle
+    @return True while chip will not acknowledge
+*/
+bool AT24CXXSim::isBusy() const {
+    return (clock_ns < _busy_until_ns);
+}
+
+/*!
+    @brief Read memory content directly
+    @param address Address to read
+    @return Byte at address
+*/
+uint8_t AT24CXXSim::peek(uint32_t address) const {
+    return _mem[address % _chip_size];
+}
+
+/*!
+    @brief Count internal write cycles started
+    @return Number of write cycles
+*/
+uint32_t AT24CXXSim::writeCycles() const {
+    return _write_cycles;
+}
+
+/*!
+    @brief Accept a write transfer addressed to this chip
+    @param address 7-bit device address as sent on the bus
+    @param data Bytes following the device address
+    @param n Number of bytes
+    @return Bytes acknowledged after the device address, -1 for NACK of the
+            device address (chip busy in write cycle)
+*/
+int AT24CXXSim::writeBytes(uint8_t address, const uint8_t* data, size_t n) {
+    int acknowledged = -1;
+    if (!isBusy()) {
+        acknowledged = (int)n;
+        if (n >= _addr_bytes) {
+            uint32_t word = 0;
+            for (uint8_t i = 0; i < _addr_bytes; i++)
+                word = (word << 8) | data[i];
+            if (_addr_ov_bits)
+                word |= (uint32_t)(address & ((1 << _addr_ov_bits) - 1)) << 8;
+            _pointer = word % _chip_size;
+        }
+        if ((n > _addr_bytes) && (_wp_pin != 0xFF) &&
+            (digitalRead(_wp_pin) == HIGH)) {
+            // Write protected: first data byte is NACKed, no write cycle
+            acknowledged = _addr_bytes;
+        } else if (n > _addr_bytes) {
+            // Page buffer rolls over within the addressed page
+            uint32_t page = _pointer - (_pointer % _page_size);
+            uint32_t offset = _pointer % _page_size;
+            for (size_t i = _addr_bytes; i < n; i++) {
+                _mem[page + offset] = data[i];
+                offset = (offset + 1) % _page_size;
+            }
+            _pointer = page + offset;
+            _busy_until_ns = clock_ns + nextCycleNs();
+            _write_cycles++;
+        }
+    }
+    return acknowledged;
+}
+
+/*!
+    @brief Serve a read transfer addressed to this chip
+    @param address 7-bit device address as sent on the bus
+    @param data Destination of bytes read
+    @param n Number of bytes requested
+    @return Number of bytes supplied, zero for NACK
+*/
+size_t AT24CXXSim::readBytes(uint8_t address, uint8_t* data, size_t n) {
+    (void)address;
+    size_t supplied = 0;
+    if (!isBusy()) {
+        while (supplied < n) {
+            data[supplied++] = _mem[_pointer];
+            if (_block_wrap && _addr_ov_bits)
+                _pointer = (_pointer & ~0xFFu) | ((_pointer + 1) & 0xFF);
+            else
+                _pointer = (_pointer + 1) % _chip_size;
+        }
+    }
+    return supplied;
+}
+
+// Private: Draw next write cycle duration from the configured range
+uint32_t AT24CXXSim::nextCycleNs() {
+    _rand_state ^= _rand_state << 13;
+    _rand_state ^= _rand_state >> 17;
+    _rand_state ^= _rand_state << 5;
+    uint32_t span = _cycle_max_us - _cycle_min_us + 1;
+    return (_cycle_min_us + (_rand_state % span)) * 1000;
+}
+
+}
+
+#endif
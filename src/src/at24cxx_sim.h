@@ -0,0 +1,201 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_sim.h
+// Purpose     : AT24CXX EEPROM Host Simulator
+// Description :
+//               This header stands in for Arduino.h and Wire.h when the
+//               AT24CXX driver is built off-target (ARDUINO not defined).
+//               It provides a TwoWire class with the subset of methods used
+//               by the driver, timing functions driven by a virtual clock,
+//               and AT24CXXSim, a model of one AT24CXX chip on a bus.
+//
+//               Every byte clocked over the simulated bus advances the
+//               virtual clock by nine bit times at the bus clock rate, plus
+//               one bit time for each START and STOP condition and any
+//               configured per-transaction overhead of the I2C driver, and
+//               delay() advances it directly, so elapsed micros() measure
+//               the time a real bus would have taken. Each call to micros()
+//               or millis() also advances the clock by 1 us. TwoWire counts
+//               transactions, bytes, NACKs and bus time for benchmarks.
+//
+//               Each simulated chip completes its internal write cycle
+//               after a pseudo-random time between the configured minimum
+//               and maximum, during which it does not acknowledge its
+//               address, as with real parts. Chips model page roll-over on
+//               write, the internal address counter, block-select bits of
+//               the device address on AT24C04/08/16, and optionally a WP
+//               pin, which causes data bytes to be NACKed while high.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : N/A
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : N/A
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_SIM_H
+#define AT24CXX_SIM_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+#ifndef I2C_BUFFER_LENGTH
+#define I2C_BUFFER_LENGTH 128
+#endif
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+namespace PeripheralIO { class AT24CXXSim; }
+
+class TwoWire {
+public:
+    TwoWire();
+
+    bool begin(int sda=-1, int scl=-1, uint32_t frequency=0);
+    void setClock(uint32_t frequency);
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t n);
+    uint8_t endTransmission(bool send_stop=true);
+    uint8_t requestFrom(uint8_t address, uint8_t n, bool send_stop=true);
+    int available();
+    int read();
+    size_t readBytes(uint8_t* buffer, size_t length);
+
+    // Simulation: chips attach themselves on construction
+    void attach(PeripheralIO::AT24CXXSim* chip);
+    void detach(PeripheralIO::AT24CXXSim* chip);
+
+    // Simulation: timing and statistics
+    void setTransactionOverhead(uint32_t ns);
+    // Add fixed time per transaction, e.g. driver and interrupt latency
+
+    uint32_t transactions() const;
+    // Returns number of transfers since construction or resetStats()
+
+    uint32_t bytesTransferred() const;
+    // Returns number of bytes clocked, including device address bytes
+
+    uint32_t nacks() const;
+    // Returns number of transfers ended by an address or data NACK
+
+    uint64_t busTimeNs() const;
+    // Returns time spent in transfers, including overhead
+
+    uint8_t lastAddress() const;
+    // Returns device address of the most recent transfer, e.g. to check
+    // block-select bits
+
+    void resetStats();
+    // Clear transaction, byte, NACK and bus time counts
+
+private:
+    PeripheralIO::AT24CXXSim* findChip(uint8_t address) const;
+    void clockTransfer(uint32_t n_bytes, bool send_stop);
+
+    static const uint8_t MAX_CHIPS = 8;
+
+    PeripheralIO::AT24CXXSim* _chips[MAX_CHIPS];
+    uint8_t _n_chips;
+    uint32_t _frequency;
+    uint32_t _overhead_ns;
+    uint32_t _transactions;
+    uint32_t _bytes;
+    uint32_t _nacks;
+    uint64_t _bus_ns;
+    uint8_t _last_addr;
+    uint8_t _tx_addr;
+    uint8_t _tx_buf[I2C_BUFFER_LENGTH];
+    size_t _tx_len;
+    uint8_t _rx_buf[I2C_BUFFER_LENGTH];
+    size_t _rx_len;
+    size_t _rx_pos;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+namespace PeripheralIO {
+
+uint64_t simClockNs();
+// Returns the virtual clock in nanoseconds
+
+void simClockAdvance(uint64_t ns);
+// Advance the virtual clock, e.g. to model CPU work between bus accesses
+
+class AT24CXXSim {
+public:
+    AT24CXXSim(uint32_t chip, uint8_t chip_addr=0, TwoWire& wire=Wire);
+    ~AT24CXXSim();
+    // Attach a simulated chip to the given bus, detached on destruction
+    // Parameter chip is the chip name, e.g. PeripheralIO::AT24C02
+    // Parameter chip_addr is the EEPROM external biasing (lowest bits)
+
+    void setWriteCycle(uint32_t min_us, uint32_t max_us);
+    // Set range of internal write cycle time (default 1500-3000 us)
+
+    void setWriteProtectPin(uint8_t pin);
+    // Honor WP connected to pin, as driven by digitalWrite()
+
+    void setBlockReadWrap(bool wrap=true);
+    // Wrap sequential reads within the 256-byte block selected by the
+    // device address, as some AT24C04/08/16 compatible parts do
+
+    bool matches(uint8_t address) const;
+    // Returns true if chip responds to 7-bit device address
+
+    bool isBusy() const;
+    // Returns true while an internal write cycle is in progress
+
+    uint8_t peek(uint32_t address) const;
+    // Returns memory content without bus access
+
+    uint32_t writeCycles() const;
+    // Returns number of internal write cycles started
+
+    // Bus side, called by TwoWire
+    // writeBytes() returns bytes acknowledged after the device address,
+    // or -1 if the device address is not acknowledged
+    int writeBytes(uint8_t address, const uint8_t* data, size_t n);
+    size_t readBytes(uint8_t address, uint8_t* data, size_t n);
+
+private:
+    AT24CXXSim(const AT24CXXSim&);
+    AT24CXXSim& operator=(const AT24CXXSim&);
+
+    uint32_t nextCycleNs();
+
+    uint8_t* _mem;
+    TwoWire* _wire;
+    uint8_t _chip_addr;
+    uint32_t _chip_size;
+    uint8_t _page_size;
+    uint8_t _addr_bytes;
+    uint8_t _addr_ov_bits;
+    uint8_t _wp_pin;
+    bool _block_wrap;
+    uint32_t _pointer;
+    uint64_t _busy_until_ns;
+    uint32_t _cycle_min_us;
+    uint32_t _cycle_max_us;
+    uint32_t _rand_state;
+    uint32_t _write_cycles;
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,316 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_static.h
+// Purpose     : AT24CXX EEPROM Compile-Time Controller Class
+// Description :
+//               This class template is a lean variant of AT24CXX for a chip
+//               type fixed at compile time, e.g.
+//
+//                   PeripheralIO::AT24CXXStatic<PeripheralIO::AT24C512> ee;
+//
+//               Chip size, page size, word address bytes and block-select
+//               bits come from AT24CXXTraits, so page arithmetic reduces to
+//               masks, unused address paths are removed by the compiler, and
+//               no chip parameters are stored per instance.
+//
+//               Reads and writes behave as the corresponding AT24CXX methods,
+//               with optional ACK polling for write cycle completion. The
+//               caching, non-blocking and telemetry features of AT24CXX are
+//               not provided.
+//
+//               The optional Bus parameter selects the I2C implementation
+//               from at24cxx_bus.h, by default Arduino TwoWire. Transfers
+//               pass the word address and data to the bus in bulk, e.g.
+//
+//                   AT24CXXStatic<AT24C512, AT24CXXEspIdfBus> ee;
+//                   ee.begin(0x00, I2C_NUM_1);
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx_chips.h, at24cxx_bus.h,
+//                                    at24cxx_wirebus.h (default Bus)
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_STATIC_H
+#define AT24CXX_STATIC_H
+
+#include "at24cxx_chips.h"
+#include "at24cxx_bus.h"
+#if defined(ARDUINO) || defined(AT24CXX_SIM_H)
+#include "at24cxx_wirebus.h" // Default Bus, where TwoWire is available
+#endif
+
+namespace PeripheralIO {
+
+template <uint32_t Chip, class Bus = AT24CXXWireBus>
+class AT24CXXStatic {
+public:
+    typedef AT24CXXTraits<Chip> Traits;
+
+    AT24CXXStatic();
+
+    void begin(uint8_t chip_addr=0, typename Bus::Port port=Bus::defaultPort(),
+               uint8_t wp_pin=-1);
+    // Initilize IO to the AT24CXX chip on the given bus port
+    // Parameter chip_addr is the EEPROM external biasing (lowest bits)
+    // Parameter port identifies the bus, e.g. Wire1 for AT24CXXWireBus
+    // Parameter wp_pin is the pin connected to WP on the chip
+
+    bool isConnected() const;
+    // Returns true for acknowledged communication with chip, else false
+
+    bool write(uint16_t address, uint8_t val) const;
+    // Write value to EEPROM address
+    // Returns false for attempt to write to invalid memory regions
+
+    bool write(uint16_t address, const uint8_t vals[], size_t n) const;
+    // Write n successive values to address
+    // Returns false for attempt to write to invalid memory regions
+
+    uint8_t read(uint16_t address) const;
+    // Read value from specific EEPROM address
+
+    bool read(uint16_t address, uint8_t vals[], size_t n) const;
+    // Read n values to location of pointer vals starting at address
+    // Returns false for attempt to read from invalid memory regions
+
+    void setWriteProtect() const;
+    // Raise WP pin so that write operations may not be applied
+
+    void clearWriteProtect() const;
+    // Release WP pin so that write operations may be applied
+
+    void setAckPolling(uint16_t timeout_us=10000);
+    // Detect write cycle completion by ACK polling instead of fixed delay
+    // On timeout, waits out the fixed delay and polls once more
+
+    void clearAckPolling();
+    // Return to fixed EEPROM_WRITE_CYCLE_TIME_MS delay after each page
+
+    static constexpr uint32_t size() { return Traits::chip_size; }
+    // Returns memory size of the chip in bytes
+
+private:
+    uint8_t deviceAddress(uint16_t) const;
+    uint8_t wordAddress(uint16_t, uint8_t*) const;
+    bool waitWriteCycle(uint8_t) const;
+
+    static constexpr uint8_t CHUNK_SIZE =
+        (Traits::page_size < Bus::MAX_TRANSFER - Traits::addr_bytes) ?
+        Traits::page_size : (Bus::MAX_TRANSFER - Traits::addr_bytes);
+
+    uint8_t _chip_addr;
+    uint8_t _wp_pin;
+    uint16_t _ack_poll_us;
+    bool _active;
+    mutable Bus _bus;
+};
+
+template <uint32_t Chip, class Bus>
+AT24CXXStatic<Chip, Bus>::AT24CXXStatic()
+: _chip_addr(0),
+  _wp_pin(-1),
+  _ack_poll_us(0),
+  _active(false),
+  _bus()
+{ }
+
+/*!
+    @brief Initialize AT24CXX using hardware I2C
+    @param chip_addr Address of EEPROM chip
+    @param port Bus of the chip
+    @param wp_pin Pin connected to WP, or -1 for none
+*/
+template <uint32_t Chip, class Bus>
+void AT24CXXStatic<Chip, Bus>::begin(uint8_t chip_addr,
+                                     typename Bus::Port port,
+                                     uint8_t wp_pin) {
+    _chip_addr = AT24CXX_ADDR | (chip_addr & 0x07);
+    _bus.begin(port);
+    _wp_pin = wp_pin;
+    if (_wp_pin != (uint8_t)-1) {
+        _bus.pinOutput(_wp_pin);
+        _bus.writePin(_wp_pin, false);
+    }
+    _active = true;
+}
+
+/*!
+    @brief Check whether AT24CXX is present
+    @return True for successful acknowledgement from chip
+*/
+template <uint32_t Chip, class Bus>
+bool AT24CXXStatic<Chip, Bus>::isConnected() const {
+    return (_active && _bus.probe(_chip_addr));
+}
+
+/*!
+    @brief Write byte to AT24CXX
+    @param address Address to write byte
+    @param val Byte to write
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+template <uint32_t Chip, class Bus>
+bool AT24CXXStatic<Chip, Bus>::write(uint16_t address, uint8_t val) const {
+    return write(address, &val, 1);
+}
+
+/*!
+    @brief Write n bytes to AT24CXX from vals
+    @param address Address to write bytes
+    @param vals Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @return False for failed to write (e.g. invalid memory regions)
+*/
+template <uint32_t Chip, class Bus>
+bool AT24CXXStatic<Chip, Bus>::write(uint16_t address, const uint8_t vals[],
+                                     size_t n) const {
+    bool result = false;
+    if (_active && ((uint32_t)(address + n) <= Traits::chip_size)) {
+        uint8_t header[2];
+        size_t n_sent = 0;
+        result = true;
+        while (result && (n_sent < n)) {
+            uint16_t at = address + n_sent;
+            // Page size is a power of two, so the modulo reduces to a mask
+            size_t len = Traits::page_size - (at % Traits::page_size);
+            if (len > CHUNK_SIZE)
+                len = CHUNK_SIZE;
+            if (len > n - n_sent)
+                len = n - n_sent;
+            uint8_t addr = deviceAddress(at);
+            result = _bus.transmit(addr, header, wordAddress(at, header),
+                                   &vals[n_sent], len) &&
+                     waitWriteCycle(addr);
+            n_sent += len;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Read byte from AT24CXX
+    @param address Address to read byte
+    @return Byte read
+*/
+template <uint32_t Chip, class Bus>
+uint8_t AT24CXXStatic<Chip, Bus>::read(uint16_t address) const {
+    uint8_t byte = 0;
+    read(address, &byte, 1);
+    return byte;
+}
+
+/*!
+    @brief Read n successive bytes from AT24CXX
+    @param address Address to read bytes
+    @param vals Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for failed to read (e.g. invalid memory regions)
+*/
+template <uint32_t Chip, class Bus>
+bool AT24CXXStatic<Chip, Bus>::read(uint16_t address, uint8_t vals[],
+                                    size_t n) const {
+    bool result = false;
+    if (_active && ((uint32_t)(address + n) <= Traits::chip_size)) {
+        size_t done = 0;
+        result = true;
+        while (result && (done < n)) {
+            // Block-select bits are part of the device address, so each
+            // 256-byte block is read as one addressed sequential read
+            uint16_t at = (uint16_t)(address + done);
+            size_t len = n - done;
+            if (Traits::addr_ov_bits && (len > 256u - (at & 0xFF)))
+                len = 256u - (at & 0xFF);
+            uint8_t header[2];
+            result = _bus.receive(deviceAddress(at), header,
+                                  wordAddress(at, header), &vals[done], len);
+            done += len;
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Raise WP pin so that write operations may not be applied
+*/
+template <uint32_t Chip, class Bus>
+void AT24CXXStatic<Chip, Bus>::setWriteProtect() const {
+    if (_wp_pin != (uint8_t)-1)
+        _bus.writePin(_wp_pin, true);
+}
+
+/*!
+    @brief Release WP pin so that write operations may be applied
+*/
+template <uint32_t Chip, class Bus>
+void AT24CXXStatic<Chip, Bus>::clearWriteProtect() const {
+    if (_wp_pin != (uint8_t)-1)
+        _bus.writePin(_wp_pin, false);
+}
+
+/*!
+    @brief Detect write cycle completion by ACK polling
+    @param timeout_us Maximum time to poll for each page write cycle
+*/
+template <uint32_t Chip, class Bus>
+void AT24CXXStatic<Chip, Bus>::setAckPolling(uint16_t timeout_us) {
+    _ack_poll_us = timeout_us;
+}
+
+/*!
+    @brief Return to fixed delay for write cycle completion
+*/
+template <uint32_t Chip, class Bus>
+void AT24CXXStatic<Chip, Bus>::clearAckPolling() {
+    _ack_poll_us = 0;
+}
+
+// Private: Device address selecting block of memory address
+template <uint32_t Chip, class Bus>
+uint8_t AT24CXXStatic<Chip, Bus>::deviceAddress(uint16_t address) const {
+    constexpr uint8_t block_mask = (uint8_t)((1 << Traits::addr_ov_bits) - 1);
+    return (uint8_t)((_chip_addr & ~block_mask) |
+                     ((address >> 8) & block_mask));
+}
+
+// Private: Format word address bytes, returns number of bytes
+template <uint32_t Chip, class Bus>
+uint8_t AT24CXXStatic<Chip, Bus>::wordAddress(uint16_t address,
+                                              uint8_t* header) const {
+    uint8_t len = 0;
+    if (Traits::addr_bytes > 1)
+        header[len++] = (uint8_t)(address >> 8);
+    header[len++] = (uint8_t)address;
+    return len;
+}
+
+// Private: Wait for completion of page write cycle
+template <uint32_t Chip, class Bus>
+bool AT24CXXStatic<Chip, Bus>::waitWriteCycle(uint8_t addr) const {
+    bool acknowledged = false;
+    if (_ack_poll_us) {
+        uint32_t start = _bus.micros();
+        do {
+            acknowledged = _bus.probe(addr);
+        } while (!acknowledged &&
+                 ((uint32_t)(_bus.micros() - start) < _ack_poll_us));
+        // Timed out: fall back to the fixed delay, rounded up to the
+        // millisecond delay of the bus, then poll once more
+        uint32_t elapsed = (uint32_t)(_bus.micros() - start);
+        uint32_t cycle_us = (uint32_t)EEPROM_WRITE_CYCLE_TIME_MS * 1000;
+        if (!acknowledged) {
+            if (elapsed < cycle_us)
+                _bus.delayMs((cycle_us - elapsed + 999) / 1000);
+            acknowledged = _bus.probe(addr);
+        }
+    } else {
+        _bus.delayMs(EEPROM_WRITE_CYCLE_TIME_MS);
+        acknowledged = true;
+    }
+    return acknowledged;
+}
+
+}
+
+#endif
@@ -0,0 +1,219 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_stream.cpp
+// Purpose     : AT24CXX EEPROM Sequential Stream Class
+// Description : This source file accompanies header file at24cxx_stream.h
+// Platform    : Multiple
+// Framework   : Arduino
+// Language    : C++
+// Copyright   : MIT License 2022, John Greenwell
+//----------------------------------------------------------------------------
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#else
+#include "at24cxx_sim.h"
+#endif
+#include <string.h>
+#include "at24cxx_stream.h"
+
+namespace PeripheralIO {
+
+AT24CXXStream::AT24CXXStream(const AT24CXX& device, uint32_t start,
+                             uint32_t end)
+: _device(&device),
+  _position(start),
+  _end((end > device.size()) ? device.size() : end),
+  _buffer(),
+  _head(0),
+  _count(0),
+  _dirty(false),
+  _failed(false)
+{ }
+
+AT24CXXStream::~AT24CXXStream() {
+    flush();
+}
+
+/*!
+    @brief Count bytes remaining in the span
+    @return Number of bytes not yet read
+*/
+size_t AT24CXXStream::available() const {
+    size_t remaining = 0;
+    if (!_failed && (_position < _end))
+        remaining = _end - _position;
+    return remaining;
+}
+
+/*!
+    @brief Read next byte of the span
+    @return Byte read, or -1 at end of span
+*/
+int AT24CXXStream::read() {
+    int val = peek();
+    if (val >= 0) {
+        _head++;
+        _count--;
+        _position++;
+    }
+    return val;
+}
+
+/*!
+    @brief Inspect next byte of the span without advancing
+    @return Next byte, or -1 at end of span
+*/
+int AT24CXXStream::peek() {
+    int val = -1;
+    if (flush() && available() && (_count || fill()))
+        val = _buffer[_head];
+    return val;
+}
+
+/*!
+    @brief Read next n bytes of the span
+    @param record Pointer to array bytes will be written to
+    @param n Number of successive bytes to read
+    @return False for fewer than n bytes remaining or failed read
+*/
+bool AT24CXXStream::read(uint8_t record[], size_t n) {
+    bool result = false;
+    if (flush() && (n <= available())) {
+        size_t done = 0;
+        result = true;
+        while (result && (done < n)) {
+            result = (_count || fill());
+            if (result) {
+                size_t len = (_count < n - done) ? _count : n - done;
+                memcpy(&record[done], &_buffer[_head], len);
+                _head += (uint8_t)len;
+                _count -= (uint8_t)len;
+                _position += (uint32_t)len;
+                done += len;
+            }
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Write byte at the next address of the span
+    @param val Byte to write
+    @return Number of bytes written, 0 at end of span
+*/
+size_t AT24CXXStream::write(uint8_t val) {
+    return write(&val, 1) ? 1 : 0;
+}
+
+/*!
+    @brief Write n bytes at the next addresses of the span
+    @param record Pointer to array of bytes
+    @param n Number of successive bytes to write
+    @return False for fewer than n bytes remaining or failed write
+*/
+bool AT24CXXStream::write(const uint8_t record[], size_t n) {
+    bool result = false;
+    if (writable() && (n <= available())) {
+        size_t done = 0;
+        result = true;
+        while (result && (done < n)) {
+            if (_count == BUFFER_SIZE)
+                result = flush();
+            if (result) {
+                size_t len = BUFFER_SIZE - _count;
+                if (len > n - done)
+                    len = n - done;
+                memcpy(&_buffer[_count], &record[done], len);
+                _count += (uint8_t)len;
+                _position += (uint32_t)len;
+                _dirty = true;
+                done += len;
+            }
+        }
+    }
+    return result;
+}
+
+/*!
+    @brief Write buffered bytes to the chip
+    @return False for failed write
+*/
+bool AT24CXXStream::flush() {
+    if (_dirty) {
+        // Buffered bytes end at the current position
+        if (!_device->write((uint16_t)(_position - _count), _buffer, _count))
+            _failed = true;
+        _head = 0;
+        _count = 0;
+        _dirty = false;
+    }
+    return !_failed;
+}
+
+/*!
+    @brief Move the next byte of the stream to address
+    @param address Chip address, up to the end of the span
+    @return False for address beyond the span or failed write
+*/
+bool AT24CXXStream::seek(uint32_t address) {
+    bool result = false;
+    if (flush() && (address <= _end)) {
+        // Keep bytes already fetched when moving forward within them
+        if ((address >= _position) && (address - _position < _count)) {
+            _head += (uint8_t)(address - _position);
+            _count -= (uint8_t)(address - _position);
+        } else {
+            _head = 0;
+            _count = 0;
+        }
+        _position = address;
+        result = true;
+    }
+    return result;
+}
+
+/*!
+    @brief Chip address of the next byte
+    @return Address
+*/
+uint32_t AT24CXXStream::position() const {
+    return _position;
+}
+
+/*!
+    @brief Check for failed chip read
+    @return True if the stream ended on a failed read
+*/
+bool AT24CXXStream::failed() const {
+    return _failed;
+}
+
+// Private: Prepare buffer to collect written bytes
+bool AT24CXXStream::writable() {
+    // Bytes fetched ahead of the position are dropped, as the write
+    // replaces them on the chip
+    if (!_dirty) {
+        _head = 0;
+        _count = 0;
+    }
+    return !_failed;
+}
+
+// Private: Fetch next chunk, continuing the chip's sequential read
+bool AT24CXXStream::fill() {
+    size_t len = available();
+    if (len > BUFFER_SIZE)
+        len = BUFFER_SIZE;
+    _head = 0;
+    _count = 0;
+    if (len) {
+        if (_device->read((uint16_t)_position, _buffer, len))
+            _count = (uint8_t)len;
+        else
+            _failed = true;
+    }
+    return (_count > 0);
+}
+
+}
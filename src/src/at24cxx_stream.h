@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_stream.h
+// Purpose     : AT24CXX EEPROM Sequential Stream Class
+// Description :
+//               This class reads forward through a span of AT24CXX memory,
+//               fetching it in chunks of BUFFER_SIZE bytes and handing out
+//               single bytes or fixed-size records from RAM. Successive
+//               chunks continue the chip's sequential read, so walking the
+//               whole chip costs one address phase per chunk, or only the
+//               first where the chip has setAddressTracking(), rather than
+//               one full transaction per byte. BUFFER_SIZE follows the Wire
+//               buffer length, so each chunk is a single read transfer.
+//
+//               Bytes written with write() are collected in the same buffer
+//               and written to the chip as one write() of the driver when
+//               the buffer fills, on flush(), before the next read or
+//               seek(), and when the stream is destroyed.
+//
+//               Bytes may be taken with read() and peek(), in the manner of
+//               Arduino streams, or with a range-based for loop:
+//
+//                   for (uint8_t b : PeripheralIO::AT24CXXStream(eeprom, 0,
+//                                                                 1024))
+//
+//               A failed chip read or write ends the stream and sets
+//               failed().
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_STREAM_H
+#define AT24CXX_STREAM_H
+
+#include "at24cxx.h"
+
+namespace PeripheralIO {
+
+class AT24CXXStream {
+public:
+    AT24CXXStream(const AT24CXX& device, uint32_t start, uint32_t end);
+    // Stream bytes of device from address start up to, excluding, end
+
+    ~AT24CXXStream();
+    // Write any buffered bytes to the chip
+
+    size_t available() const;
+    // Returns number of bytes remaining in the span
+
+    int read();
+    // Returns next byte and advances, or -1 at end of span
+
+    int peek();
+    // Returns next byte without advancing, or -1 at end of span
+
+    bool read(uint8_t record[], size_t n);
+    // Copy the next n bytes to record and advance past them
+    // Returns false if fewer than n bytes remain
+
+    size_t write(uint8_t val);
+    // Write val at the next address and advance
+    // Returns 1, or 0 at end of span or after a failed chip access
+
+    bool write(const uint8_t record[], size_t n);
+    // Write n bytes of record from the next address and advance past them
+    // Returns false if fewer than n bytes remain or a chip write failed
+
+    bool flush();
+    // Write buffered bytes to the chip
+    // Returns false for failed write
+
+    bool seek(uint32_t address);
+    // Move the next byte to address, writing buffered bytes first
+    // Returns false for address beyond the span or failed write
+
+    uint32_t position() const;
+    // Returns chip address of the next byte
+
+    bool failed() const;
+    // Returns true if a chip read failed
+
+    class iterator {
+    public:
+        explicit iterator(AT24CXXStream* stream) : _stream(stream) { }
+        uint8_t operator*() const { return (uint8_t)_stream->peek(); }
+        iterator& operator++() { _stream->read(); return *this; }
+        bool operator!=(const iterator& other) const {
+            return atEnd() != other.atEnd();
+        }
+    private:
+        bool atEnd() const { return !_stream || !_stream->available(); }
+        AT24CXXStream* _stream;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(nullptr); }
+
+    static const uint8_t BUFFER_SIZE =
+        (AT24CXX_BUFFER_LENGTH < 255) ? AT24CXX_BUFFER_LENGTH : 255;
+
+private:
+    bool fill();
+    bool writable();
+
+    const AT24CXX* _device;
+    uint32_t _position;
+    uint32_t _end;
+    uint8_t _buffer[BUFFER_SIZE];
+    uint8_t _head;
+    uint8_t _count;
+    bool _dirty;
+    bool _failed;
+};
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+//----------------------------------------------------------------------------
+// Name        : at24cxx_wirebus.h
+// Purpose     : AT24CXX EEPROM Arduino TwoWire Bus Policy
+// Description :
+//               This class is the default bus policy of AT24CXXStatic (see
+//               at24cxx_bus.h), transferring through an Arduino TwoWire
+//               object, e.g. Wire1. Writes are bounded by the Wire transmit
+//               buffer and reads are fetched in chunks of it.
+//
+//               On host builds the simulator of at24cxx_sim.h provides
+//               TwoWire, and must be included first.
+//
+// Platform    : Multiple
+// Language    : C++
+// Framework   : Arduino
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_bus.h
+//----------------------------------------------------------------------------
+#ifndef AT24CXX_WIREBUS_H
+#define AT24CXX_WIREBUS_H
+
+#include "at24cxx.h"
+#include "at24cxx_bus.h"
+
+namespace PeripheralIO {
+
+class AT24CXXWireBus {
+public:
+    typedef TwoWire& Port;
+    static constexpr size_t MAX_TRANSFER = AT24CXX_BUFFER_LENGTH;
+
+    static Port defaultPort() { return Wire; }
+
+    AT24CXXWireBus() : _wire(nullptr) { }
+
+    void begin(Port port) { _wire = &port; }
+
+    bool probe(uint8_t addr) {
+        _wire->beginTransmission(addr);
+        return (_wire->endTransmission() == 0);
+    }
+
+    bool transmit(uint8_t addr, const uint8_t* header, uint8_t header_len,
+                  const uint8_t* data, size_t n) {
+        _wire->beginTransmission(addr);
+        _wire->write(header, header_len);
+        if (n)
+            _wire->write(data, n);
+        return (_wire->endTransmission() == 0);
+    }
+
+    bool receive(uint8_t addr, const uint8_t* header, uint8_t header_len,
+                 uint8_t* data, size_t n) {
+        bool result = true;
+        if (header_len) {
+            _wire->beginTransmission(addr);
+            _wire->write(header, header_len);
+            result = (_wire->endTransmission(false) == 0);
+        }
+        size_t done = 0;
+        while (result && (done < n)) {
+            uint8_t len = (uint8_t)((n - done < READ_SIZE) ? n - done
+                                                            : READ_SIZE);
+            uint8_t got = _wire->requestFrom(addr, len);
+            done += _wire->readBytes(&data[done], got);
+            result = (got != 0);
+        }
+        return result;
+    }
+
+    uint32_t micros() const { return ::micros(); }
+    void delayMs(uint32_t ms) const { ::delay(ms); }
+    void pinOutput(uint8_t pin) const { ::pinMode(pin, OUTPUT); }
+    void writePin(uint8_t pin, bool high) const {
+        ::digitalWrite(pin, high ? HIGH : LOW);
+    }
+
+private:
+    static constexpr uint8_t READ_SIZE =
+        (AT24CXX_BUFFER_LENGTH < 255) ? AT24CXX_BUFFER_LENGTH : 255;
+
+    TwoWire* _wire;
+};
+
+}
+
+#endif
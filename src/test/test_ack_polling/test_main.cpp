@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Write Cycle Completion Tests
+// Description :
+//               These tests drive AT24CXX against the host simulator of
+//               at24cxx_sim.h, checking page writes completed by ACK
+//               polling and by the fixed delay, failures for write protect
+//               and absent chips, and the fallback to the fixed delay when
+//               a chip is still busy at the polling timeout.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+const uint32_t CYCLE_US = (uint32_t)EEPROM_WRITE_CYCLE_TIME_MS * 1000;
+
+uint8_t pattern[512];
+uint8_t readback[512];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+void onWriteDone(bool success, void* context) {
+    *(int*)context = success ? 1 : 0;
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 7 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire, WP_PIN);
+    eeprom->setAckPolling();
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+}
+
+void test_polled_write_reads_back(void) {
+    TEST_ASSERT_TRUE(eeprom->write(30, pattern, 200));
+    TEST_ASSERT_TRUE(eeprom->read(30, readback, 200));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 200);
+    // 64-byte pages: 30-63, 64-127, 128-191, 192-229
+    TEST_ASSERT_EQUAL_UINT32(4, sim->writeCycles());
+}
+
+void test_polling_faster_than_fixed_delay(void) {
+    uint64_t start = simClockNs();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 256));
+    uint64_t polled_ns = simClockNs() - start;
+    eeprom->clearAckPolling();
+    start = simClockNs();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 256));
+    uint64_t delayed_ns = simClockNs() - start;
+    TEST_ASSERT_GREATER_OR_EQUAL(4ULL * CYCLE_US * 1000, delayed_ns);
+    TEST_ASSERT_LESS_THAN(delayed_ns, polled_ns);
+}
+
+void test_out_of_range_rejected(void) {
+    TEST_ASSERT_FALSE(eeprom->write(32760, pattern, 9));
+    TEST_ASSERT_FALSE(eeprom->read(32760, readback, 9));
+    TEST_ASSERT_EQUAL_UINT32(0, sim->writeCycles());
+}
+
+void test_write_protected_fails(void) {
+    eeprom->setWriteProtect();
+    TEST_ASSERT_FALSE(eeprom->write(0, pattern, 100));
+    eeprom->clearAckPolling();
+    TEST_ASSERT_FALSE(eeprom->write(0, pattern, 100));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(0));
+    eeprom->clearWriteProtect();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 100));
+    TEST_ASSERT_EQUAL_HEX8(pattern[0], sim->peek(0));
+}
+
+void test_absent_chip_fails(void) {
+    AT24CXX absent;
+    absent.begin(AT24C256, 5, Wire);
+    TEST_ASSERT_FALSE(absent.write(0, pattern, 10));
+    absent.setAckPolling();
+    TEST_ASSERT_FALSE(absent.write(0, pattern, 10));
+    TEST_ASSERT_FALSE(absent.read(0, readback, 10));
+}
+
+void test_poll_timeout_falls_back_to_fixed_delay(void) {
+    // Busy past the 1 ms polling timeout, done within the fixed delay
+    sim->setWriteCycle(3000, 3000);
+    eeprom->setAckPolling(1000);
+    uint64_t start = simClockNs();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 64));
+    TEST_ASSERT_GREATER_OR_EQUAL((uint64_t)CYCLE_US * 1000,
+                                 simClockNs() - start);
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 64));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 64);
+}
+
+void test_poll_timeout_fails_when_still_busy(void) {
+    // Still busy after the fixed delay, so the write is reported failed
+    sim->setWriteCycle(8000, 8000);
+    eeprom->setAckPolling(1000);
+    TEST_ASSERT_FALSE(eeprom->write(0, pattern, 128));
+    // The first page was accepted, the second never sent
+    TEST_ASSERT_EQUAL_UINT32(1, sim->writeCycles());
+    simClockAdvance(5000000);
+    sim->setWriteCycle(1500, 3000);
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 128));
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 128));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 128);
+}
+
+void test_async_poll_timeout_falls_back(void) {
+    sim->setWriteCycle(3000, 3000);
+    eeprom->setAckPolling(1000);
+    int done = -1;
+    TEST_ASSERT_TRUE(eeprom->writeAsync(0, pattern, 128, onWriteDone,
+                                        &done));
+    while (eeprom->service()) { }
+    TEST_ASSERT_EQUAL_INT(1, done);
+    sim->setWriteCycle(8000, 8000);
+    done = -1;
+    TEST_ASSERT_TRUE(eeprom->writeAsync(0, &pattern[128], 128, onWriteDone,
+                                        &done));
+    while (eeprom->service()) { }
+    TEST_ASSERT_EQUAL_INT(0, done);
+    simClockAdvance(5000000);
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 64));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[128], readback, 64);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_polled_write_reads_back);
+    RUN_TEST(test_polling_faster_than_fixed_delay);
+    RUN_TEST(test_out_of_range_rejected);
+    RUN_TEST(test_write_protected_fails);
+    RUN_TEST(test_absent_chip_fails);
+    RUN_TEST(test_poll_timeout_falls_back_to_fixed_delay);
+    RUN_TEST(test_poll_timeout_fails_when_still_busy);
+    RUN_TEST(test_async_poll_timeout_falls_back);
+    return UNITY_END();
+}
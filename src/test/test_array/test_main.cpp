@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Striped Volume Tests
+// Description :
+//               These tests drive AT24CXXArray against several chips of
+//               the host simulator of at24cxx_sim.h sharing one bus,
+//               checking the data read back, its placement in page-sized
+//               stripes across the chips, and rejection of chips of
+//               another type.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_array.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_array.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t N_CHIPS = 4;
+
+uint8_t pattern[8192];
+uint8_t readback[8192];
+AT24CXXSim* sims[N_CHIPS];
+AT24CXX* chips[N_CHIPS];
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 29 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    for (uint8_t i = 0; i < N_CHIPS; i++) {
+        sims[i] = new AT24CXXSim(AT24C256, i, Wire);
+        chips[i] = new AT24CXX();
+        chips[i]->begin(AT24C256, i, Wire);
+        chips[i]->setAckPolling();
+    }
+}
+
+void tearDown(void) {
+    for (uint8_t i = 0; i < N_CHIPS; i++) {
+        delete chips[i];
+        delete sims[i];
+    }
+}
+
+void test_array_stripes_across_chips(void) {
+    AT24CXXArray array;
+    for (uint8_t i = 0; i < N_CHIPS; i++)
+        TEST_ASSERT_TRUE(array.add(*chips[i]));
+    TEST_ASSERT_EQUAL_UINT32(N_CHIPS * 32768UL, array.size());
+    TEST_ASSERT_TRUE(array.write(10, pattern, 5000));
+    TEST_ASSERT_TRUE(array.read(10, readback, 5000));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 5000);
+    // 64-byte stripes: bytes 64-127 of the volume are the second chip's
+    // first page
+    TEST_ASSERT_EQUAL_HEX8(pattern[64 - 10], sims[1]->peek(0));
+    TEST_ASSERT_EQUAL_HEX8(pattern[4 * 64 - 10], sims[0]->peek(64));
+    TEST_ASSERT_FALSE(array.write(array.size() - 5, pattern, 6));
+}
+
+void test_array_single_chip_writes_all_stripes(void) {
+    AT24CXXArray array;
+    TEST_ASSERT_TRUE(array.add(*chips[0]));
+    TEST_ASSERT_TRUE(array.write(3, pattern, 1000));
+    TEST_ASSERT_TRUE(chips[0]->read(3, readback, 1000));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 1000);
+}
+
+void test_array_rejects_mismatched_chip(void) {
+    AT24CXXSim small_sim(AT24C02, 7, Wire);
+    AT24CXX small;
+    small.begin(AT24C02, 7, Wire);
+    AT24CXXArray array;
+    TEST_ASSERT_TRUE(array.add(*chips[0]));
+    TEST_ASSERT_FALSE(array.add(small));
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_array_stripes_across_chips);
+    RUN_TEST(test_array_single_chip_writes_all_stripes);
+    RUN_TEST(test_array_rejects_mismatched_chip);
+    return UNITY_END();
+}
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Non-Blocking Write Tests
+// Description :
+//               These tests drive the non-blocking write engine of AT24CXX
+//               against the host simulator of at24cxx_sim.h, checking
+//               completion callbacks, refusal of calls while a write is
+//               pending, and failures reported through the callback.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+
+uint8_t pattern[512];
+uint8_t readback[512];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+void onWriteDone(bool success, void* context) {
+    *(int*)context = success ? 1 : 0;
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 11 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire, WP_PIN);
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+}
+
+void test_async_write_completes(void) {
+    int done = -1;
+    uint32_t calls = 0;
+    TEST_ASSERT_TRUE(eeprom->writeAsync(10, pattern, 300, onWriteDone,
+                                        &done));
+    TEST_ASSERT_TRUE(eeprom->isWriteBusy());
+    while (eeprom->service())
+        calls++;
+    TEST_ASSERT_EQUAL_INT(1, done);
+    TEST_ASSERT_FALSE(eeprom->isWriteBusy());
+    // Returns after each step rather than blocking for the whole write
+    TEST_ASSERT_GREATER_THAN(5, calls);
+    TEST_ASSERT_TRUE(eeprom->read(10, readback, 300));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 300);
+}
+
+void test_async_write_with_polling(void) {
+    int done = -1;
+    eeprom->setAckPolling();
+    TEST_ASSERT_TRUE(eeprom->writeAsync(0, pattern, 200, onWriteDone,
+                                        &done));
+    while (eeprom->service()) { }
+    TEST_ASSERT_EQUAL_INT(1, done);
+    TEST_ASSERT_EQUAL_HEX8(pattern[199], sim->peek(199));
+}
+
+void test_calls_refused_while_pending(void) {
+    TEST_ASSERT_TRUE(eeprom->writeAsync(0, pattern, 100));
+    TEST_ASSERT_FALSE(eeprom->writeAsync(1000, pattern, 10));
+    TEST_ASSERT_FALSE(eeprom->write(1000, pattern, 10));
+    TEST_ASSERT_FALSE(eeprom->read(0, readback, 10));
+    while (eeprom->service()) { }
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 100));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 100);
+}
+
+void test_out_of_range_rejected(void) {
+    TEST_ASSERT_FALSE(eeprom->writeAsync(32760, pattern, 9));
+    TEST_ASSERT_FALSE(eeprom->isWriteBusy());
+}
+
+void test_write_protected_reports_failure(void) {
+    int done = -1;
+    eeprom->setWriteProtect();
+    TEST_ASSERT_TRUE(eeprom->writeAsync(0, pattern, 100, onWriteDone,
+                                        &done));
+    while (eeprom->service()) { }
+    TEST_ASSERT_EQUAL_INT(0, done);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(0));
+    eeprom->clearWriteProtect();
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_async_write_completes);
+    RUN_TEST(test_async_write_with_polling);
+    RUN_TEST(test_calls_refused_while_pending);
+    RUN_TEST(test_out_of_range_rejected);
+    RUN_TEST(test_write_protected_reports_failure);
+    return UNITY_END();
+}
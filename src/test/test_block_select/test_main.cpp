@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Block Select Tests
+// Description :
+//               These tests drive AT24CXX against the host simulator of
+//               at24cxx_sim.h on the AT24C04/08/16, whose memory address
+//               runs over into block-select bits of the device address.
+//               The simulated chips wrap sequential reads within each
+//               256-byte block, as some compatible parts do, so a read
+//               that ran on across a block boundary without a new device
+//               address would return bytes from the start of the block.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+uint8_t pattern[2048];
+uint8_t readback[2048];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+// Attach a fresh chip of the given type, wrapping reads within blocks
+void attach(uint32_t chip, uint8_t chip_addr=0) {
+    delete eeprom;
+    delete sim;
+    sim = new AT24CXXSim(chip, chip_addr, Wire);
+    sim->setBlockReadWrap();
+    eeprom = new AT24CXX();
+    eeprom->begin(chip, chip_addr, Wire);
+    eeprom->setAckPolling();
+    Wire.resetStats();
+}
+
+// Fill the chip with the pattern and forget the address counter
+void fill(uint32_t n) {
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, n));
+    memset(readback, 0, sizeof(readback));
+}
+
+// Write n bytes of the pattern at address and check the chip's contents
+void checkWrite(uint16_t address, uint16_t n, uint8_t device_address) {
+    for (uint16_t i = 0; i < n; i++)
+        pattern[address + i] ^= 0xA5;
+    TEST_ASSERT_TRUE(eeprom->write(address, &pattern[address], n));
+    TEST_ASSERT_EQUAL_HEX8(device_address, Wire.lastAddress());
+    for (uint16_t i = 0; i < n; i++)
+        TEST_ASSERT_EQUAL_HEX8(pattern[address + i], sim->peek(address + i));
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 7 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    attach(AT24C04);
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_read_across_block(void) {
+    fill(512);
+    TEST_ASSERT_TRUE(eeprom->read(0xE0, readback, 16));
+    TEST_ASSERT_EQUAL_HEX8(0x50, Wire.lastAddress());
+    // 0xF0-0x10F: the second half is addressed afresh in block 1
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(0xF0, &readback[0xF0], 32));
+    TEST_ASSERT_EQUAL_HEX8(0x51, Wire.lastAddress());
+    TEST_ASSERT_EQUAL_UINT32(4, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0xF0], &readback[0xF0], 32);
+}
+
+void test_read_across_block_with_tracking(void) {
+    fill(512);
+    eeprom->setAddressTracking();
+    TEST_ASSERT_TRUE(eeprom->read(0xE0, &readback[0xE0], 16));
+    // Continuing within block 0 is a current address read alone
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(0xF0, &readback[0xF0], 16));
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.transactions());
+    TEST_ASSERT_EQUAL_HEX8(0x50, Wire.lastAddress());
+    // The chip's counter wrapped to 0x00, so block 1 needs its address
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(0x100, &readback[0x100], 16));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+    TEST_ASSERT_EQUAL_HEX8(0x51, Wire.lastAddress());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0xE0], &readback[0xE0], 48);
+    // A single read spanning the boundary is split the same way
+    TEST_ASSERT_TRUE(eeprom->read(0xF8, readback, 16));
+    TEST_ASSERT_EQUAL_HEX8(0x51, Wire.lastAddress());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0xF8], readback, 16);
+}
+
+void test_write_across_block(void) {
+    attach(AT24C08);
+    fill(1024);
+    checkWrite(0x2F8, 16, 0x53);
+    TEST_ASSERT_TRUE(eeprom->read(0x2F0, readback, 32));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0x2F0], readback, 32);
+}
+
+void test_write_across_block_with_tracking(void) {
+    attach(AT24C08);
+    fill(1024);
+    eeprom->setAddressTracking();
+    TEST_ASSERT_TRUE(eeprom->read(0x1F0, readback, 8));
+    checkWrite(0x1F8, 16, 0x52);
+    // Reads after the write are addressed afresh, in either block
+    TEST_ASSERT_TRUE(eeprom->read(0x1F8, readback, 16));
+    TEST_ASSERT_EQUAL_HEX8(0x52, Wire.lastAddress());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0x1F8], readback, 16);
+    TEST_ASSERT_TRUE(eeprom->read(0x1F0, readback, 8));
+    TEST_ASSERT_EQUAL_HEX8(0x51, Wire.lastAddress());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0x1F0], readback, 8);
+}
+
+void test_read_through_several_blocks(void) {
+    attach(AT24C16);
+    fill(2048);
+    for (uint8_t tracking = 0; tracking < 2; tracking++) {
+        if (tracking)
+            eeprom->setAddressTracking();
+        memset(readback, 0, sizeof(readback));
+        // 0x5F0-0x70F touches blocks 5, 6 and 7
+        TEST_ASSERT_TRUE(eeprom->read(0x5F0, readback, 0x120));
+        TEST_ASSERT_EQUAL_HEX8(0x57, Wire.lastAddress());
+        TEST_ASSERT_EQUAL_MEMORY(&pattern[0x5F0], readback, 0x120);
+    }
+    checkWrite(0x7F8, 8, 0x57);
+}
+
+void test_block_bits_keep_chip_select_pins(void) {
+    // The AT24C04 needs one block bit, leaving A2 and A1 to the pins
+    attach(AT24C04, 0x06);
+    fill(512);
+    TEST_ASSERT_TRUE(eeprom->read(0xF8, readback, 16));
+    TEST_ASSERT_EQUAL_HEX8(0x57, Wire.lastAddress());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[0xF8], readback, 16);
+    TEST_ASSERT_TRUE(eeprom->read(0x00, readback, 1));
+    TEST_ASSERT_EQUAL_HEX8(0x56, Wire.lastAddress());
+    checkWrite(0xFC, 8, 0x57);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_read_across_block);
+    RUN_TEST(test_read_across_block_with_tracking);
+    RUN_TEST(test_write_across_block);
+    RUN_TEST(test_write_across_block_with_tracking);
+    RUN_TEST(test_read_through_several_blocks);
+    RUN_TEST(test_block_bits_keep_chip_select_pins);
+    return UNITY_END();
+}
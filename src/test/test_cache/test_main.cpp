@@ -0,0 +1,252 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Page Cache Tests
+// Description :
+//               These tests drive AT24CXXCache against the host simulator
+//               of at24cxx_sim.h. Read hits and page replacement are
+//               checked from the cache's counters, write-back by counting
+//               the simulated chip's write cycles before and after a
+//               flush, and the observer chain by writing through the
+//               driver while caches are attached and released.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_cache.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_cache.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+
+uint8_t pattern[1024];
+uint8_t readback[1024];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 13 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire, WP_PIN);
+    eeprom->setAckPolling();
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_cache_writes_back_on_flush(void) {
+    uint8_t buffer[256];
+    AT24CXXCache cache;
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    uint32_t cycles = sim->writeCycles();
+    for (uint8_t i = 0; i < 20; i++)
+        TEST_ASSERT_TRUE(cache.write(i, pattern[i]));
+    TEST_ASSERT_EQUAL_UINT32(cycles, sim->writeCycles());
+    TEST_ASSERT_EQUAL_HEX8(pattern[5], cache.read(5));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(5));
+    // The dirty span of the page goes out as one page write
+    TEST_ASSERT_TRUE(cache.flush());
+    TEST_ASSERT_EQUAL_UINT32(cycles + 1, sim->writeCycles());
+    TEST_ASSERT_EQUAL_HEX8(pattern[19], sim->peek(19));
+    TEST_ASSERT_TRUE(cache.flush());
+    TEST_ASSERT_EQUAL_UINT32(cycles + 1, sim->writeCycles());
+}
+
+void test_cache_writes_back_on_eviction(void) {
+    uint8_t buffer[128];
+    AT24CXXCache cache;
+    // Two 64-byte pages fit, so a third page evicts the oldest
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    TEST_ASSERT_TRUE(cache.write(0, pattern, 8));
+    TEST_ASSERT_TRUE(cache.write(64, &pattern[64], 8));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(0));
+    TEST_ASSERT_TRUE(cache.read(128, readback, 8));
+    TEST_ASSERT_EQUAL_HEX8(pattern[7], sim->peek(7));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(64));
+}
+
+void test_cache_service_flushes_after_interval(void) {
+    uint8_t buffer[256];
+    AT24CXXCache cache;
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    cache.setFlushInterval(10);
+    TEST_ASSERT_TRUE(cache.write(200, pattern, 4));
+    TEST_ASSERT_TRUE(cache.service());
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(200));
+    simClockAdvance(11000000);
+    TEST_ASSERT_TRUE(cache.service());
+    TEST_ASSERT_EQUAL_HEX8(pattern[3], sim->peek(203));
+}
+
+void test_cache_long_transfers(void) {
+    uint8_t buffer[512];
+    AT24CXXCache cache;
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    // More bytes than the cache holds, passed as one length
+    TEST_ASSERT_TRUE(cache.write(1000, pattern, sizeof(pattern)));
+    TEST_ASSERT_TRUE(cache.flush());
+    TEST_ASSERT_TRUE(eeprom->read(1000, readback, sizeof(readback)));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, sizeof(pattern));
+    memset(readback, 0, sizeof(readback));
+    TEST_ASSERT_TRUE(cache.read(1000, readback, sizeof(readback)));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, sizeof(pattern));
+    TEST_ASSERT_FALSE(cache.write(32700, pattern, 100));
+}
+
+void test_cache_released_from_observer_chain(void) {
+    uint8_t buffer_a[128];
+    uint8_t buffer_b[128];
+    AT24CXXCache cache_a;
+    TEST_ASSERT_TRUE(cache_a.begin(*eeprom, buffer_a, sizeof(buffer_a)));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, cache_a.read(10));
+    {
+        AT24CXXCache cache_b;
+        TEST_ASSERT_TRUE(cache_b.begin(*eeprom, buffer_b,
+                                       sizeof(buffer_b)));
+        TEST_ASSERT_EQUAL_HEX8(0xFF, cache_b.read(10));
+    }
+    // Only cache_a remains registered, and still sees direct writes
+    void* context = nullptr;
+    TEST_ASSERT_NOT_NULL(eeprom->writeObserver(&context));
+    TEST_ASSERT_EQUAL_PTR(&cache_a, context);
+    TEST_ASSERT_TRUE(eeprom->write(10, (uint8_t)42));
+    TEST_ASSERT_EQUAL_HEX8(42, cache_a.read(10));
+}
+
+void test_cache_released_out_of_order(void) {
+    uint8_t buffer_a[128];
+    uint8_t buffer_b[128];
+    AT24CXXCache cache_b;
+    {
+        AT24CXXCache cache_a;
+        TEST_ASSERT_TRUE(cache_a.begin(*eeprom, buffer_a,
+                                       sizeof(buffer_a)));
+        TEST_ASSERT_TRUE(cache_b.begin(*eeprom, buffer_b,
+                                       sizeof(buffer_b)));
+    }
+    // cache_a was unlinked from behind cache_b
+    TEST_ASSERT_EQUAL_HEX8(0xFF, cache_b.read(10));
+    TEST_ASSERT_TRUE(eeprom->write(10, (uint8_t)42));
+    TEST_ASSERT_EQUAL_HEX8(42, cache_b.read(10));
+}
+
+void test_cache_begin_on_another_chip(void) {
+    uint8_t buffer[128];
+    AT24CXXSim other_sim(AT24C256, 1, Wire);
+    AT24CXX other;
+    other.begin(AT24C256, 1, Wire);
+    other.setAckPolling();
+    AT24CXXCache cache;
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    TEST_ASSERT_TRUE(cache.begin(other, buffer, sizeof(buffer)));
+    TEST_ASSERT_NULL(eeprom->writeObserver());
+    TEST_ASSERT_TRUE(eeprom->write(10, (uint8_t)42));
+    TEST_ASSERT_TRUE(other.write(10, (uint8_t)7));
+    TEST_ASSERT_EQUAL_HEX8(7, cache.read(10));
+    // begin() again on the same chip does not chain the cache to itself
+    TEST_ASSERT_TRUE(cache.begin(other, buffer, sizeof(buffer)));
+    void* context = nullptr;
+    TEST_ASSERT_NOT_NULL(other.writeObserver(&context));
+    TEST_ASSERT_EQUAL_PTR(&cache, context);
+    TEST_ASSERT_EQUAL_HEX8(7, cache.read(10));
+    TEST_ASSERT_TRUE(other.write(10, (uint8_t)9));
+    TEST_ASSERT_EQUAL_HEX8(9, cache.read(10));
+}
+
+void test_cache_serves_repeated_reads(void) {
+    uint8_t buffer[256];
+    AT24CXXCache cache;
+    TEST_ASSERT_TRUE(eeprom->write(100, pattern, 16));
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    Wire.resetStats();
+    for (uint8_t i = 0; i < 100; i++) {
+        TEST_ASSERT_TRUE(cache.read(100, readback, 16));
+        TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 16);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, cache.misses());
+    TEST_ASSERT_EQUAL_UINT32(99, cache.hits());
+    // One page load: an address phase and a data phase
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+}
+
+void test_cache_evicts_least_recently_used(void) {
+    uint8_t buffer[128];
+    AT24CXXCache cache;
+    // Two 64-byte pages fit the budget
+    TEST_ASSERT_TRUE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    cache.read(0);
+    cache.read(64);
+    cache.read(0);
+    // Page 1 is least recently used, so page 2 replaces it
+    cache.read(128);
+    TEST_ASSERT_EQUAL_UINT32(3, cache.misses());
+    cache.read(0);
+    TEST_ASSERT_EQUAL_UINT32(3, cache.misses());
+    cache.read(64);
+    TEST_ASSERT_EQUAL_UINT32(4, cache.misses());
+    TEST_ASSERT_EQUAL_UINT32(2, cache.hits());
+}
+
+void test_cache_rejects_buffer_below_one_page(void) {
+    uint8_t buffer[63];
+    AT24CXXCache cache;
+    TEST_ASSERT_FALSE(cache.begin(*eeprom, buffer, sizeof(buffer)));
+    TEST_ASSERT_FALSE(cache.read(0, readback, 1));
+}
+
+void test_cache_sees_direct_writes(void) {
+    uint8_t buffer_a[128];
+    uint8_t buffer_b[128];
+    AT24CXXCache cache_a;
+    AT24CXXCache cache_b;
+    TEST_ASSERT_TRUE(cache_a.begin(*eeprom, buffer_a, sizeof(buffer_a)));
+    TEST_ASSERT_TRUE(cache_b.begin(*eeprom, buffer_b, sizeof(buffer_b)));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, cache_a.read(10));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, cache_b.read(10));
+    TEST_ASSERT_TRUE(eeprom->write(10, (uint8_t)42));
+    TEST_ASSERT_EQUAL_HEX8(42, cache_a.read(10));
+    TEST_ASSERT_EQUAL_HEX8(42, cache_b.read(10));
+    // A flush from one cache reaches the other through the chip
+    TEST_ASSERT_TRUE(cache_a.write(11, (uint8_t)43));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, cache_b.read(11));
+    TEST_ASSERT_TRUE(cache_a.flush());
+    TEST_ASSERT_EQUAL_HEX8(43, cache_b.read(11));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cache_serves_repeated_reads);
+    RUN_TEST(test_cache_evicts_least_recently_used);
+    RUN_TEST(test_cache_rejects_buffer_below_one_page);
+    RUN_TEST(test_cache_sees_direct_writes);
+    RUN_TEST(test_cache_writes_back_on_flush);
+    RUN_TEST(test_cache_writes_back_on_eviction);
+    RUN_TEST(test_cache_service_flushes_after_interval);
+    RUN_TEST(test_cache_long_transfers);
+    RUN_TEST(test_cache_released_from_observer_chain);
+    RUN_TEST(test_cache_released_out_of_order);
+    RUN_TEST(test_cache_begin_on_another_chip);
+    return UNITY_END();
+}
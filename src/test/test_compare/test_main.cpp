@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Read-Compare Write Tests
+// Description :
+//               These tests drive AT24CXX with setWriteCompare() against
+//               the host simulator of at24cxx_sim.h. The simulated chip's
+//               write cycles show which pages were programmed, and the
+//               driver's counters must agree with them.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+
+uint8_t record[200];
+uint8_t readback[200];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(record); i++)
+        record[i] = (uint8_t)(i * 7);
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    // 32-byte pages, so a 200-byte record spans seven pages
+    sim = new AT24CXXSim(AT24C64, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C64, 0, Wire, WP_PIN);
+    eeprom->setAckPolling();
+    TEST_ASSERT_TRUE(eeprom->write(0, record, sizeof(record)));
+    eeprom->resetPageCounters();
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_write_compare_skips_unchanged_pages(void) {
+    uint32_t cycles = sim->writeCycles();
+    record[100] ^= 0xFF;
+    eeprom->setWriteCompare();
+    TEST_ASSERT_TRUE(eeprom->write(0, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_UINT32(cycles + 1, sim->writeCycles());
+    TEST_ASSERT_EQUAL_UINT32(1, eeprom->pagesWritten());
+    TEST_ASSERT_EQUAL_UINT32(6, eeprom->pagesSkipped());
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, sizeof(record)));
+    TEST_ASSERT_EQUAL_MEMORY(record, readback, sizeof(record));
+}
+
+void test_write_compare_span_only(void) {
+    uint32_t cycles = sim->writeCycles();
+    record[70] ^= 0xFF;
+    record[72] ^= 0xFF;
+    record[150] ^= 0xFF;
+    eeprom->setWriteCompare(true);
+    TEST_ASSERT_TRUE(eeprom->write(0, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_UINT32(cycles + 2, sim->writeCycles());
+    TEST_ASSERT_EQUAL_UINT32(2, eeprom->pagesWritten());
+    TEST_ASSERT_EQUAL_UINT32(5, eeprom->pagesSkipped());
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, sizeof(record)));
+    TEST_ASSERT_EQUAL_MEMORY(record, readback, sizeof(record));
+}
+
+void test_write_compare_unchanged_record(void) {
+    uint32_t cycles = sim->writeCycles();
+    eeprom->setWriteCompare();
+    TEST_ASSERT_TRUE(eeprom->write(0, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_UINT32(cycles, sim->writeCycles());
+    TEST_ASSERT_EQUAL_UINT32(0, eeprom->pagesWritten());
+    TEST_ASSERT_EQUAL_UINT32(7, eeprom->pagesSkipped());
+}
+
+void test_failed_page_not_counted(void) {
+    record[0] ^= 0xFF;
+    eeprom->setWriteCompare();
+    eeprom->setWriteProtect();
+    TEST_ASSERT_FALSE(eeprom->write(0, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_UINT32(0, eeprom->pagesWritten());
+    eeprom->clearWriteProtect();
+    TEST_ASSERT_TRUE(eeprom->write(0, record, sizeof(record)));
+    TEST_ASSERT_EQUAL_UINT32(1, eeprom->pagesWritten());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_write_compare_skips_unchanged_pages);
+    RUN_TEST(test_write_compare_span_only);
+    RUN_TEST(test_write_compare_unchanged_record);
+    RUN_TEST(test_failed_page_not_counted);
+    return UNITY_END();
+}
@@ -0,0 +1,207 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM CRC-32 Record Tests
+// Description :
+//               These tests drive AT24CXXCrc against the host simulator of
+//               at24cxx_sim.h, checking records, write cycles and bus
+//               traffic, damage made through the driver, and agreement of
+//               the CRC-32 kernels.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_crc.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_crc.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+uint8_t pattern[1024];
+uint8_t readback[1024];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+AT24CXXCrc* crc = nullptr;
+uint8_t observed[1024];
+
+// Copy the bytes of every page write, as a cache would
+void onWrite(uint16_t address, const uint8_t* vals, uint16_t n,
+             void* context) {
+    (void)context;
+    memcpy(&observed[address], vals, n);
+}
+
+// Attach a fresh chip of the given type, with ACK polling
+void attach(uint32_t chip) {
+    delete crc;
+    delete eeprom;
+    delete sim;
+    sim = new AT24CXXSim(chip, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(chip, 0, Wire);
+    eeprom->setAckPolling();
+    crc = new AT24CXXCrc();
+    crc->begin(*eeprom);
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 13 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    attach(AT24C256);
+}
+
+void tearDown(void) {
+    delete crc;
+    delete eeprom;
+    delete sim;
+    crc = nullptr;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_crc_record_verifies(void) {
+    TEST_ASSERT_TRUE(crc->write(50, pattern, 100));
+    TEST_ASSERT_TRUE(crc->read(50, readback, 100));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 100);
+    TEST_ASSERT_TRUE(crc->verify(50, 100));
+    TEST_ASSERT_EQUAL_UINT32(0, crc->failures());
+    TEST_ASSERT_FALSE(crc->write(32760, pattern, 5));
+    // The CRC follows the record, least significant byte first
+    uint32_t expected = AT24CXXCrc::crc32(0, pattern, 100);
+    for (uint8_t i = 0; i < AT24CXXCrc::CRC_SIZE; i++)
+        TEST_ASSERT_EQUAL_HEX8((uint8_t)(expected >> (8 * i)),
+                               sim->peek(150 + i));
+}
+
+void test_crc_empty_record(void) {
+    TEST_ASSERT_TRUE(crc->write(10, pattern, 0));
+    TEST_ASSERT_TRUE(crc->read(10, readback, 0));
+    TEST_ASSERT_TRUE(crc->verify(10, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x00, sim->peek(10));
+}
+
+void test_crc_write_cycles_at_page_end(void) {
+    // 60 bytes leave room for the CRC in the 64-byte page
+    uint32_t cycles = sim->writeCycles();
+    TEST_ASSERT_TRUE(crc->write(0, pattern, 60));
+    TEST_ASSERT_EQUAL_UINT32(cycles + 1, sim->writeCycles());
+    // 64 bytes fill the page, so the CRC takes a write of its own
+    cycles = sim->writeCycles();
+    TEST_ASSERT_TRUE(crc->write(128, pattern, 64));
+    TEST_ASSERT_EQUAL_UINT32(cycles + 2, sim->writeCycles());
+    TEST_ASSERT_TRUE(crc->verify(128, 64));
+    // Two bytes short of the page end, the CRC straddles two pages
+    cycles = sim->writeCycles();
+    TEST_ASSERT_TRUE(crc->write(256, pattern, 62));
+    TEST_ASSERT_EQUAL_UINT32(cycles + 2, sim->writeCycles());
+    TEST_ASSERT_TRUE(crc->read(256, readback, 62));
+}
+
+void test_crc_read_is_one_sequential_transfer(void) {
+    TEST_ASSERT_TRUE(crc->write(0, pattern, 200));
+    TEST_ASSERT_TRUE(crc->write(300, pattern, 16));
+    // 16 bytes and the CRC: one address phase and one data phase
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(crc->read(300, readback, 16));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 16);
+    // 204 bytes in two 128-byte data phases after one address phase
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(crc->read(0, readback, 200));
+    TEST_ASSERT_EQUAL_UINT32(3, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 200);
+}
+
+void test_crc_read_across_blocks(void) {
+    attach(AT24C16);
+    // Record and CRC run over the 256-byte block boundary at 0x200
+    TEST_ASSERT_TRUE(crc->write(0x1F0, pattern, 40));
+    TEST_ASSERT_TRUE(crc->read(0x1F0, readback, 40));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 40);
+    TEST_ASSERT_TRUE(crc->verify(0x1F0, 40));
+    // CRC alone past the boundary
+    TEST_ASSERT_TRUE(crc->write(0x2F0, pattern, 16));
+    TEST_ASSERT_TRUE(crc->read(0x2F0, readback, 16));
+    TEST_ASSERT_EQUAL_UINT32(0, crc->failures());
+}
+
+void test_crc_observer_sees_record_and_crc(void) {
+    memset(observed, 0xFF, sizeof(observed));
+    eeprom->setWriteObserver(onWrite);
+    // Record and CRC share the page at 64, then the CRC crosses to 128
+    TEST_ASSERT_TRUE(crc->write(70, pattern, 56));
+    for (uint16_t i = 70; i < 130; i++)
+        TEST_ASSERT_EQUAL_HEX8(sim->peek(i), observed[i]);
+}
+
+void test_crc_write_compare_skips_unchanged(void) {
+    TEST_ASSERT_TRUE(crc->write(0, pattern, 100));
+    eeprom->setWriteCompare();
+    uint32_t cycles = sim->writeCycles();
+    TEST_ASSERT_TRUE(crc->write(0, pattern, 100));
+    TEST_ASSERT_EQUAL_UINT32(cycles, sim->writeCycles());
+    // A change in the record reprograms its page and the CRC's
+    pattern[10] ^= 0xFF;
+    TEST_ASSERT_TRUE(crc->write(0, pattern, 100));
+    TEST_ASSERT_EQUAL_UINT32(cycles + 2, sim->writeCycles());
+    TEST_ASSERT_TRUE(crc->read(0, readback, 100));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 100);
+}
+
+void test_crc_detects_corruption(void) {
+    TEST_ASSERT_TRUE(crc->write(0, pattern, 64));
+    TEST_ASSERT_TRUE(eeprom->write(20, (uint8_t)(pattern[20] ^ 0x10)));
+    TEST_ASSERT_FALSE(crc->verify(0, 64));
+    TEST_ASSERT_FALSE(crc->read(0, readback, 64));
+    TEST_ASSERT_EQUAL_UINT32(2, crc->failures());
+    // Damage to the stored CRC itself
+    TEST_ASSERT_TRUE(crc->write(200, pattern, 30));
+    TEST_ASSERT_TRUE(eeprom->write(231, (uint8_t)(sim->peek(231) ^ 0x01)));
+    TEST_ASSERT_FALSE(crc->read(200, readback, 30));
+    TEST_ASSERT_EQUAL_UINT32(3, crc->failures());
+}
+
+void test_crc_kernels_agree(void) {
+    // Check value of CRC-32 (IEEE 802.3) over "123456789"
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, AT24CXXCrc::crc32(0, check, 9));
+    uint32_t expected = AT24CXXCrc::crc32Bitwise(0, pattern, 1000);
+    TEST_ASSERT_EQUAL_HEX32(expected,
+                            AT24CXXCrc::crc32Nibble(0, pattern, 1000));
+    TEST_ASSERT_EQUAL_HEX32(expected,
+                            AT24CXXCrc::crc32Slicing4(0, pattern, 1000));
+    TEST_ASSERT_EQUAL_HEX32(expected,
+                            AT24CXXCrc::crc32Slicing8(0, pattern, 1000));
+    uint32_t split = AT24CXXCrc::crc32(AT24CXXCrc::crc32(0, pattern, 333),
+                                       &pattern[333], 667);
+    TEST_ASSERT_EQUAL_HEX32(expected, split);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_record_verifies);
+    RUN_TEST(test_crc_empty_record);
+    RUN_TEST(test_crc_write_cycles_at_page_end);
+    RUN_TEST(test_crc_read_is_one_sequential_transfer);
+    RUN_TEST(test_crc_read_across_blocks);
+    RUN_TEST(test_crc_observer_sees_record_and_crc);
+    RUN_TEST(test_crc_write_compare_skips_unchanged);
+    RUN_TEST(test_crc_detects_corruption);
+    RUN_TEST(test_crc_kernels_agree);
+    return UNITY_END();
+}
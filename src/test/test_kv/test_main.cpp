@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Key-Value Store Tests
+// Description :
+//               These tests drive AT24CXXKV against the host simulator of
+//               at24cxx_sim.h. Persistence is checked by mounting a fresh
+//               store over the same simulated chip, and wear levelling by
+//               the page write counts of the driver's wear tracking.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_kv.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_kv.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+uint8_t pattern[128];
+uint8_t readback[128];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+// Value of length n stored for key in a given round
+void fillValue(uint8_t* value, uint16_t key, uint16_t round, uint8_t n) {
+    for (uint8_t i = 0; i < n; i++)
+        value[i] = (uint8_t)(key * 31 + round + i);
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 13 + 5);
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire);
+    eeprom->setAckPolling();
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_kv_values_survive_remount(void) {
+    AT24CXXKVEntry index[8];
+    AT24CXXKV kv;
+    TEST_ASSERT_TRUE(kv.begin(*eeprom, 1024, 1024, index, 8));
+    for (uint16_t round = 0; round < 50; round++) {
+        for (uint16_t key = 1; key <= 4; key++) {
+            uint8_t value[8];
+            fillValue(value, key, round, sizeof(value));
+            TEST_ASSERT_TRUE(kv.put(key, value, key * 2));
+        }
+        kv.service();
+    }
+    TEST_ASSERT_TRUE(kv.flush());
+
+    AT24CXXKVEntry remount_index[8];
+    AT24CXXKV remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 1024, 1024, remount_index, 8));
+    TEST_ASSERT_EQUAL_UINT16(4, remount.count());
+    for (uint16_t key = 1; key <= 4; key++) {
+        uint8_t value[8];
+        uint8_t expected[8];
+        fillValue(expected, key, 49, sizeof(expected));
+        TEST_ASSERT_EQUAL_UINT8(key * 2, remount.length(key));
+        TEST_ASSERT_TRUE(remount.get(key, value, sizeof(value)));
+        TEST_ASSERT_EQUAL_MEMORY(expected, value, key * 2);
+    }
+    TEST_ASSERT_FALSE(remount.get(9, readback, 1));
+}
+
+void test_kv_unflushed_values_lost(void) {
+    AT24CXXKVEntry index[4];
+    AT24CXXKV kv;
+    TEST_ASSERT_TRUE(kv.begin(*eeprom, 0, 512, index, 4));
+    TEST_ASSERT_TRUE(kv.put(1, pattern, 4));
+    TEST_ASSERT_TRUE(kv.flush());
+    TEST_ASSERT_TRUE(kv.put(2, pattern, 4));
+
+    AT24CXXKVEntry remount_index[4];
+    AT24CXXKV remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 512, remount_index, 4));
+    TEST_ASSERT_EQUAL_UINT8(4, remount.length(1));
+    TEST_ASSERT_EQUAL_UINT8(0, remount.length(2));
+}
+
+void test_kv_rejects_invalid_puts(void) {
+    AT24CXXKVEntry index[2];
+    AT24CXXKV kv;
+    TEST_ASSERT_FALSE(kv.begin(*eeprom, 0, 128, index, 2));
+    TEST_ASSERT_TRUE(kv.begin(*eeprom, 0, 512, index, 2));
+    // 64-byte pages less the page and record headers
+    TEST_ASSERT_EQUAL_UINT8(53, kv.maxValue());
+    TEST_ASSERT_FALSE(kv.put(1, pattern, 54));
+    TEST_ASSERT_TRUE(kv.put(1, pattern, 53));
+    TEST_ASSERT_TRUE(kv.put(2, pattern, 1));
+    // The index holds two keys
+    TEST_ASSERT_FALSE(kv.put(3, pattern, 1));
+    TEST_ASSERT_TRUE(kv.put(2, pattern, 2));
+    TEST_ASSERT_TRUE(kv.get(1, readback, 53));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 53);
+}
+
+void test_kv_spreads_wear(void) {
+    // 16 pages of 64 bytes hold the log
+    uint32_t counts[512] = { 0 };
+    TEST_ASSERT_TRUE(eeprom->setWearTracking(counts, 512));
+    AT24CXXKVEntry index[4];
+    AT24CXXKV kv;
+    TEST_ASSERT_TRUE(kv.begin(*eeprom, 0, 1024, index, 4));
+    // One hot key, updated and flushed every time
+    for (uint16_t round = 0; round < 400; round++) {
+        uint8_t value[16];
+        fillValue(value, 1, round, sizeof(value));
+        TEST_ASSERT_TRUE(kv.put(1, value, sizeof(value)));
+        TEST_ASSERT_TRUE(kv.flush());
+        kv.service();
+    }
+    uint32_t least = counts[0];
+    uint32_t most = counts[0];
+    for (uint16_t page = 1; page < 16; page++) {
+        if (counts[page] < least)
+            least = counts[page];
+        if (counts[page] > most)
+            most = counts[page];
+    }
+    // Every page of the region takes a share of the writes
+    TEST_ASSERT_GREATER_THAN(0, least);
+    TEST_ASSERT_LESS_THAN(2 * least + 4, most);
+    uint8_t expected[16];
+    fillValue(expected, 1, 399, sizeof(expected));
+    TEST_ASSERT_TRUE(kv.get(1, readback, sizeof(expected)));
+    TEST_ASSERT_EQUAL_MEMORY(expected, readback, sizeof(expected));
+}
+
+void test_kv_damaged_record_ignored(void) {
+    AT24CXXKVEntry index[4];
+    AT24CXXKV kv;
+    TEST_ASSERT_TRUE(kv.begin(*eeprom, 0, 512, index, 4));
+    TEST_ASSERT_TRUE(kv.put(1, pattern, 4));
+    TEST_ASSERT_TRUE(kv.flush());
+    TEST_ASSERT_TRUE(kv.put(1, &pattern[4], 4));
+    TEST_ASSERT_TRUE(kv.flush());
+    // Damage the value of the newer record, as a torn write would
+    uint16_t at = 0;
+    while ((at < 512) && (sim->peek(at) != pattern[4]))
+        at++;
+    TEST_ASSERT_LESS_THAN(512, at);
+    TEST_ASSERT_TRUE(eeprom->write(at, (uint8_t)~pattern[4]));
+
+    AT24CXXKVEntry remount_index[4];
+    AT24CXXKV remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 512, remount_index, 4));
+    TEST_ASSERT_TRUE(remount.get(1, readback, 4));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 4);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_kv_values_survive_remount);
+    RUN_TEST(test_kv_unflushed_values_lost);
+    RUN_TEST(test_kv_rejects_invalid_puts);
+    RUN_TEST(test_kv_spreads_wear);
+    RUN_TEST(test_kv_damaged_record_ignored);
+    return UNITY_END();
+}
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX Linux i2c-dev Bus Policy Tests
+// Description :
+//               These tests drive AT24CXXStatic over AT24CXXLinuxBus with
+//               an in-process fake of the I2C_RDWR ioctl, which models an
+//               AT24C512 behind /dev/null. They are built without the rest
+//               of the library, so they also check that the Linux policy
+//               does not depend on Arduino or Wire.
+//
+// Platform    : Linux (glibc)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx_static.h, at24cxx_linux.h
+//----------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_linux.h"
+#include "at24cxx_static.h"
+
+#ifndef __THROW
+#define __THROW
+#endif
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t CHIP_ADDR = 0x50;
+const uint32_t CHIP_SIZE = 65536;
+const uint8_t PAGE_SIZE = 128;
+
+uint8_t chip[CHIP_SIZE];
+uint32_t pointer = 0;
+uint8_t busy_polls = 0;   // NACKs still to give after a write
+uint8_t busy_after = 0;   // NACKs to give after each write
+uint32_t ioctl_calls = 0;
+uint32_t messages = 0;
+
+// Serve one message as the chip would, returns false for NACK
+bool serve(const struct i2c_msg& msg) {
+    bool result = (msg.addr == CHIP_ADDR) && !busy_polls;
+    if (!result && busy_polls) {
+        busy_polls--;
+    } else if (result && (msg.flags & I2C_M_RD)) {
+        for (uint16_t i = 0; i < msg.len; i++) {
+            msg.buf[i] = chip[pointer];
+            pointer = (pointer + 1) % CHIP_SIZE;
+        }
+    } else if (result && (msg.len >= 2)) {
+        pointer = ((uint32_t)msg.buf[0] << 8) | msg.buf[1];
+        uint32_t page = pointer - (pointer % PAGE_SIZE);
+        for (uint16_t i = 2; i < msg.len; i++) {
+            chip[page + (pointer % PAGE_SIZE)] = msg.buf[i];
+            pointer = page + ((pointer + 1) % PAGE_SIZE);
+        }
+        if (msg.len > 2)
+            busy_polls = busy_after;
+    }
+    return result;
+}
+
+}
+
+// Fake of the i2c-dev interface, replacing the C library's ioctl()
+extern "C" int ioctl(int fd, unsigned long request, ...) __THROW {
+    int result = -1;
+    va_list args;
+    va_start(args, request);
+    struct i2c_rdwr_ioctl_data* xfer =
+        va_arg(args, struct i2c_rdwr_ioctl_data*);
+    va_end(args);
+    ioctl_calls++;
+    errno = ENXIO;
+    if ((fd >= 0) && (request == I2C_RDWR)) {
+        bool acknowledged = true;
+        for (uint32_t i = 0; acknowledged && (i < xfer->nmsgs); i++) {
+            messages++;
+            acknowledged = serve(xfer->msgs[i]);
+        }
+        if (acknowledged)
+            result = (int)xfer->nmsgs;
+    }
+    return result;
+}
+
+AT24CXXStatic<AT24C512, AT24CXXLinuxBus> eeprom;
+uint8_t pattern[CHIP_SIZE];
+uint8_t readback[CHIP_SIZE];
+
+void setUp(void) {
+    memset(chip, 0xFF, sizeof(chip));
+    pointer = 0;
+    busy_polls = 0;
+    busy_after = 0;
+    ioctl_calls = 0;
+    messages = 0;
+    for (uint32_t i = 0; i < CHIP_SIZE; i++)
+        pattern[i] = (uint8_t)(i * 131 + (i >> 8));
+    eeprom.begin(0x00, "/dev/null");
+}
+
+void tearDown(void) { }
+
+void test_connected(void) {
+    AT24CXXStatic<AT24C512, AT24CXXLinuxBus> absent;
+    absent.begin(0x03, "/dev/null");
+    TEST_ASSERT_TRUE(eeprom.isConnected());
+    TEST_ASSERT_FALSE(absent.isConnected());
+}
+
+void test_write_crossing_pages(void) {
+    TEST_ASSERT_TRUE(eeprom.write(100, pattern, 300));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, &chip[100], 300);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, chip[99]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, chip[400]);
+    // Pages 0 (28 bytes), 1, 2 and 3 (16 bytes): one ioctl each
+    TEST_ASSERT_EQUAL_UINT32(4, ioctl_calls);
+}
+
+void test_read_matches_write(void) {
+    TEST_ASSERT_TRUE(eeprom.write(1000, pattern, 517));
+    TEST_ASSERT_TRUE(eeprom.read(1000, readback, 517));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 517);
+    TEST_ASSERT_EQUAL_UINT8(pattern[0], eeprom.read(1000));
+}
+
+void test_whole_chip_read_is_one_ioctl(void) {
+    memcpy(chip, pattern, CHIP_SIZE);
+    TEST_ASSERT_TRUE(eeprom.read(0, readback, CHIP_SIZE));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, CHIP_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(1, ioctl_calls);
+    // Word address, then 8 reads of the 8192-byte message limit
+    TEST_ASSERT_EQUAL_UINT32(9, messages);
+}
+
+void test_out_of_range_rejected(void) {
+    TEST_ASSERT_FALSE(eeprom.read(CHIP_SIZE - 4, readback, 5));
+    TEST_ASSERT_FALSE(eeprom.write(CHIP_SIZE - 4, pattern, 5));
+    TEST_ASSERT_EQUAL_UINT32(0, ioctl_calls);
+}
+
+void test_ack_polling_waits_for_write_cycle(void) {
+    busy_after = 3;
+    eeprom.setAckPolling();
+    TEST_ASSERT_TRUE(eeprom.write(0, pattern, 200));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, chip, 200);
+    // Two pages, each followed by three NACKed polls and one ACK
+    TEST_ASSERT_EQUAL_UINT32(2 + 2 * 4, ioctl_calls);
+    eeprom.clearAckPolling();
+}
+
+void test_nack_fails_transfer(void) {
+    AT24CXXStatic<AT24C512, AT24CXXLinuxBus> absent;
+    absent.begin(0x03, "/dev/null");
+    TEST_ASSERT_FALSE(absent.write(0, pattern, 10));
+    TEST_ASSERT_FALSE(absent.read(0, readback, 10));
+}
+
+void test_unopened_device_fails(void) {
+    AT24CXXStatic<AT24C512, AT24CXXLinuxBus> missing;
+    missing.begin(0x00, "/nonexistent/i2c-9");
+    TEST_ASSERT_FALSE(missing.isConnected());
+    TEST_ASSERT_FALSE(missing.read(0, readback, 10));
+    TEST_ASSERT_EQUAL_UINT32(0, ioctl_calls);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_connected);
+    RUN_TEST(test_write_crossing_pages);
+    RUN_TEST(test_read_matches_write);
+    RUN_TEST(test_whole_chip_read_is_one_ioctl);
+    RUN_TEST(test_out_of_range_rejected);
+    RUN_TEST(test_ack_polling_waits_for_write_cycle);
+    RUN_TEST(test_nack_fails_transfer);
+    RUN_TEST(test_unopened_device_fails);
+    return UNITY_END();
+}
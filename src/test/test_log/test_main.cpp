@@ -0,0 +1,196 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Circular Append Log Tests
+// Description :
+//               These tests drive AT24CXXLog against the host simulator of
+//               at24cxx_sim.h. Recovery is checked by mounting a fresh log
+//               over the same simulated chip, its cost by the bus
+//               transactions of begin(), and damage by overwriting bytes
+//               through the driver.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_log.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_log.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+uint8_t pattern[256];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+// Attach a fresh chip of the given type, with ACK polling
+void attach(uint32_t chip) {
+    delete eeprom;
+    delete sim;
+    sim = new AT24CXXSim(chip, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(chip, 0, Wire);
+    eeprom->setAckPolling();
+}
+
+// Append n records of up to 16 bytes, each holding its number from first
+void appendNumbered(AT24CXXLog& log, uint32_t first, uint32_t n) {
+    uint8_t record[16] = { 0 };
+    for (uint32_t id = first; id < first + n; id++) {
+        memcpy(record, &id, sizeof(id));
+        TEST_ASSERT_TRUE(log.append(record));
+    }
+}
+
+// Number held in record
+uint32_t recordNumber(const uint8_t* record) {
+    uint32_t id = 0;
+    memcpy(&id, record, sizeof(id));
+    return id;
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 13 + 7);
+    Wire.setClock(400000);
+    attach(AT24C256);
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_log_recovers_after_wrap(void) {
+    const uint8_t RECORD = 12;
+    AT24CXXLog log;
+    TEST_ASSERT_TRUE(log.begin(*eeprom, 0, 2048, RECORD));
+    // More records than the 32 pages hold, so the oldest are replaced
+    appendNumbered(log, 0, 400);
+    TEST_ASSERT_TRUE(log.flush());
+    uint32_t count = log.count();
+    TEST_ASSERT_LESS_THAN(400, count);
+
+    AT24CXXLog remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 2048, RECORD));
+    TEST_ASSERT_EQUAL_UINT32(count, remount.count());
+    TEST_ASSERT_EQUAL_UINT32(log.sequence(), remount.sequence());
+    uint8_t record[RECORD];
+    for (uint32_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(remount.read(i, record));
+        TEST_ASSERT_EQUAL_UINT32(400 - count + i, recordNumber(record));
+    }
+    TEST_ASSERT_FALSE(remount.read(count, record));
+}
+
+void test_log_unflushed_records_lost(void) {
+    const uint8_t RECORD = 8;
+    AT24CXXLog log;
+    TEST_ASSERT_TRUE(log.begin(*eeprom, 0, 1024, RECORD));
+    appendNumbered(log, 0, 3);
+    TEST_ASSERT_TRUE(log.flush());
+    appendNumbered(log, 3, 2);
+    TEST_ASSERT_EQUAL_UINT32(5, log.count());
+
+    AT24CXXLog remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 1024, RECORD));
+    TEST_ASSERT_EQUAL_UINT32(3, remount.count());
+    // Appending continues after the records that were written
+    appendNumbered(remount, 3, 1);
+    TEST_ASSERT_TRUE(remount.flush());
+    uint8_t record[RECORD];
+    TEST_ASSERT_TRUE(remount.read(3, record));
+    TEST_ASSERT_EQUAL_UINT32(3, recordNumber(record));
+}
+
+void test_log_damaged_record_rejected(void) {
+    const uint8_t RECORD = 8;
+    AT24CXXLog log;
+    TEST_ASSERT_TRUE(log.begin(*eeprom, 0, 1024, RECORD));
+    // Two full 64-byte pages of six records and a third page in RAM
+    for (uint8_t i = 0; i < 14; i++)
+        TEST_ASSERT_TRUE(log.append(&pattern[i * RECORD]));
+    TEST_ASSERT_TRUE(log.flush());
+    // Flip a byte of record 2: after the 5-byte page header and two
+    // records of 8 bytes and a check byte each
+    uint8_t address = 5 + 2 * (RECORD + 1) + 3;
+    TEST_ASSERT_TRUE(eeprom->write(address,
+                                   (uint8_t)(pattern[2 * RECORD + 3] ^ 1)));
+
+    AT24CXXLog remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 1024, RECORD));
+    TEST_ASSERT_EQUAL_UINT32(14, remount.count());
+    uint8_t record[RECORD];
+    for (uint8_t i = 0; i < 14; i++) {
+        if (i == 2) {
+            TEST_ASSERT_FALSE(remount.read(i, record));
+        } else {
+            TEST_ASSERT_TRUE(remount.read(i, record));
+            TEST_ASSERT_EQUAL_MEMORY(&pattern[i * RECORD], record, RECORD);
+        }
+    }
+}
+
+void test_log_torn_page_header_ignored(void) {
+    const uint8_t RECORD = 8;
+    AT24CXXLog log;
+    TEST_ASSERT_TRUE(log.begin(*eeprom, 0, 1024, RECORD));
+    // Pages 0 and 1 full, page 2 holding two records
+    appendNumbered(log, 0, 14);
+    TEST_ASSERT_TRUE(log.flush());
+    // Damage the sequence number of the newest page
+    TEST_ASSERT_TRUE(eeprom->write(128, (uint8_t)(sim->peek(128) ^ 0x10)));
+
+    AT24CXXLog remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 1024, RECORD));
+    TEST_ASSERT_EQUAL_UINT32(12, remount.count());
+    uint8_t record[RECORD];
+    TEST_ASSERT_TRUE(remount.read(11, record));
+    TEST_ASSERT_EQUAL_UINT32(11, recordNumber(record));
+}
+
+void test_log_head_found_by_binary_search(void) {
+    // 512 pages of 128 bytes, wrapped part way round
+    attach(AT24C512);
+    const uint8_t RECORD = 16;
+    AT24CXXLog log;
+    TEST_ASSERT_TRUE(log.begin(*eeprom, 0, 65536, RECORD));
+    uint32_t n = 600 * (128 / (RECORD + 1));
+    appendNumbered(log, 0, n);
+    TEST_ASSERT_TRUE(log.flush());
+
+    AT24CXXStats stats;
+    memset(&stats, 0, sizeof(stats));
+    eeprom->setTelemetry(&stats);
+    AT24CXXLog remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 65536, RECORD));
+    eeprom->clearTelemetry();
+    // A few dozen header reads, not one per page
+    TEST_ASSERT_LESS_THAN(64, stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(log.count(), remount.count());
+    uint8_t record[RECORD];
+    TEST_ASSERT_TRUE(remount.read(remount.count() - 1, record));
+    TEST_ASSERT_EQUAL_UINT32(n - 1, recordNumber(record));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_log_recovers_after_wrap);
+    RUN_TEST(test_log_unflushed_records_lost);
+    RUN_TEST(test_log_damaged_record_rejected);
+    RUN_TEST(test_log_torn_page_header_ignored);
+    RUN_TEST(test_log_head_found_by_binary_search);
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Mirrored Volume Tests
+// Description :
+//               These tests drive AT24CXXMirror against two chips of the
+//               host simulator of at24cxx_sim.h, checking that writes
+//               reach both chips, that reads survive the loss of one, and
+//               that resync() repairs a differing secondary.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_mirror.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_mirror.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t N_CHIPS = 2;
+
+uint8_t pattern[8192];
+uint8_t readback[8192];
+AT24CXXSim* sims[N_CHIPS];
+AT24CXX* chips[N_CHIPS];
+
+void onWriteDone(bool success, void* context) {
+    *(int*)context = success ? 1 : 0;
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 29 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    for (uint8_t i = 0; i < N_CHIPS; i++) {
+        sims[i] = new AT24CXXSim(AT24C256, i, Wire);
+        chips[i] = new AT24CXX();
+        chips[i]->begin(AT24C256, i, Wire);
+        chips[i]->setAckPolling();
+    }
+}
+
+void tearDown(void) {
+    for (uint8_t i = 0; i < N_CHIPS; i++) {
+        delete chips[i];
+        delete sims[i];
+    }
+}
+
+void test_mirror_writes_both_chips(void) {
+    AT24CXXMirror mirror;
+    mirror.begin(*chips[0], *chips[1]);
+    TEST_ASSERT_EQUAL_UINT32(32768, mirror.size());
+    TEST_ASSERT_TRUE(mirror.write(100, pattern, 1000));
+    for (uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE(chips[i]->read(100, readback, 1000));
+        TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 1000);
+    }
+    TEST_ASSERT_TRUE(mirror.read(100, readback, 1000));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 1000);
+}
+
+void test_mirror_async_write(void) {
+    AT24CXXMirror mirror;
+    mirror.begin(*chips[0], *chips[1]);
+    int done = -1;
+    TEST_ASSERT_TRUE(mirror.writeAsync(0, pattern, 300, onWriteDone, &done));
+    while (mirror.service()) { }
+    TEST_ASSERT_EQUAL_INT(1, done);
+    TEST_ASSERT_EQUAL_HEX8(pattern[299], sims[0]->peek(299));
+    TEST_ASSERT_EQUAL_HEX8(pattern[299], sims[1]->peek(299));
+}
+
+void test_mirror_read_survives_lost_chip(void) {
+    AT24CXXMirror mirror;
+    mirror.begin(*chips[0], *chips[1]);
+    TEST_ASSERT_TRUE(mirror.write(0, pattern, 64));
+    delete sims[0];
+    sims[0] = new AT24CXXSim(AT24C256, 6, Wire);
+    for (uint8_t i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(mirror.read(0, readback, 64));
+        TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 64);
+    }
+}
+
+void test_mirror_resync_repairs_secondary(void) {
+    AT24CXXMirror mirror;
+    mirror.begin(*chips[0], *chips[1]);
+    TEST_ASSERT_TRUE(mirror.write(0, pattern, 512));
+    TEST_ASSERT_TRUE(chips[1]->write(200, (uint8_t)(pattern[200] ^ 0xFF)));
+    TEST_ASSERT_TRUE(mirror.resync());
+    TEST_ASSERT_EQUAL_HEX8(pattern[200], sims[1]->peek(200));
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_mirror_writes_both_chips);
+    RUN_TEST(test_mirror_async_write);
+    RUN_TEST(test_mirror_read_survives_lost_chip);
+    RUN_TEST(test_mirror_resync_repairs_secondary);
+    return UNITY_END();
+}
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Read-Ahead Prefetch Tests
+// Description :
+//               These tests drive AT24CXX with setPrefetch() against the
+//               host simulator of at24cxx_sim.h, reading structures field
+//               by field and checking the data, the prefetch counters and
+//               the number of bus transactions each pattern costs.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+uint8_t pattern[256];
+uint8_t readback[256];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 7 + 1);
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire);
+    eeprom->setAckPolling();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, sizeof(pattern)));
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_prefetch_serves_continuing_reads(void) {
+    eeprom->setPrefetch();
+    Wire.resetStats();
+    for (uint16_t i = 0; i < 256; i += 16)
+        TEST_ASSERT_TRUE(eeprom->read(i, &readback[i], 16));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 256);
+    TEST_ASSERT_EQUAL_UINT32(16, eeprom->prefetchHits() +
+                                 eeprom->prefetchMisses());
+    TEST_ASSERT_GREATER_THAN(eeprom->prefetchMisses(),
+                             eeprom->prefetchHits());
+    // Sixteen field reads cost fewer than the 32 transactions without
+    TEST_ASSERT_LESS_THAN(32, Wire.transactions());
+}
+
+void test_prefetch_not_taken_for_scattered_reads(void) {
+    eeprom->setPrefetch();
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(200, readback, 4));
+    TEST_ASSERT_TRUE(eeprom->read(10, readback, 4));
+    TEST_ASSERT_TRUE(eeprom->read(100, readback, 4));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[100], readback, 4);
+    // No read continued the last, so nothing was fetched ahead
+    TEST_ASSERT_EQUAL_UINT32(6, Wire.transactions());
+    TEST_ASSERT_EQUAL_UINT32(0, eeprom->prefetchHits());
+    TEST_ASSERT_EQUAL_UINT32(3, eeprom->prefetchMisses());
+}
+
+void test_prefetch_refreshed_by_own_write(void) {
+    eeprom->setPrefetch();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 8));
+    TEST_ASSERT_TRUE(eeprom->read(8, readback, 8));
+    TEST_ASSERT_TRUE(eeprom->write(16, (uint8_t)0xA5));
+    TEST_ASSERT_TRUE(eeprom->read(16, readback, 1));
+    TEST_ASSERT_EQUAL_HEX8(0xA5, readback[0]);
+}
+
+void test_prefetch_cleared(void) {
+    eeprom->setPrefetch();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 8));
+    TEST_ASSERT_TRUE(eeprom->read(8, readback, 8));
+    eeprom->clearPrefetch();
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(16, readback, 8));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[16], readback, 8);
+}
+
+void test_prefetch_stops_at_end_of_memory(void) {
+    TEST_ASSERT_TRUE(eeprom->write(32752, pattern, 16));
+    eeprom->setPrefetch();
+    TEST_ASSERT_TRUE(eeprom->read(32752, readback, 4));
+    TEST_ASSERT_TRUE(eeprom->read(32756, &readback[4], 4));
+    TEST_ASSERT_TRUE(eeprom->read(32760, &readback[8], 8));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 16);
+    TEST_ASSERT_EQUAL_UINT32(1, eeprom->prefetchHits());
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_prefetch_serves_continuing_reads);
+    RUN_TEST(test_prefetch_not_taken_for_scattered_reads);
+    RUN_TEST(test_prefetch_refreshed_by_own_write);
+    RUN_TEST(test_prefetch_cleared);
+    RUN_TEST(test_prefetch_stops_at_end_of_memory);
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Shadow Slot Tests
+// Description :
+//               These tests drive AT24CXXShadow against the host simulator
+//               of at24cxx_sim.h. Atomicity is checked by mounting a fresh
+//               instance over the same simulated chip after commits that
+//               failed, or whose header entry or slot data was damaged
+//               through the driver.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_shadow.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_shadow.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+
+uint8_t pattern[2048];
+uint8_t readback[2048];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+// Attach a fresh chip of the given type, with ACK polling
+void attach(uint32_t chip) {
+    delete eeprom;
+    delete sim;
+    sim = new AT24CXXSim(chip, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXX();
+    eeprom->begin(chip, 0, Wire, WP_PIN);
+    eeprom->setAckPolling();
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 13 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    attach(AT24C256);
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_shadow_commit_survives_remount(void) {
+    AT24CXXShadow shadow;
+    TEST_ASSERT_TRUE(shadow.begin(*eeprom, 100, 200));
+    TEST_ASSERT_EQUAL_UINT32(0, shadow.generation());
+    TEST_ASSERT_TRUE(shadow.commit(pattern, 200));
+    TEST_ASSERT_TRUE(shadow.commit(&pattern[1000], 150));
+
+    AT24CXXShadow remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 100, 200));
+    TEST_ASSERT_EQUAL_UINT32(2, remount.generation());
+    TEST_ASSERT_EQUAL_UINT16(150, remount.length());
+    TEST_ASSERT_TRUE(remount.read(0, readback, 150));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[1000], readback, 150);
+    TEST_ASSERT_FALSE(remount.read(100, readback, 51));
+    TEST_ASSERT_FALSE(remount.commit(pattern, 201));
+}
+
+void test_shadow_failed_commit_keeps_previous(void) {
+    AT24CXXShadow shadow;
+    TEST_ASSERT_TRUE(shadow.begin(*eeprom, 0, 100));
+    TEST_ASSERT_TRUE(shadow.commit(pattern, 100));
+    TEST_ASSERT_TRUE(shadow.commit(&pattern[100], 100));
+    eeprom->setWriteProtect();
+    TEST_ASSERT_FALSE(shadow.commit(&pattern[200], 100));
+    eeprom->clearWriteProtect();
+    TEST_ASSERT_EQUAL_UINT32(2, shadow.generation());
+
+    AT24CXXShadow remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 100));
+    TEST_ASSERT_EQUAL_UINT32(2, remount.generation());
+    TEST_ASSERT_TRUE(remount.read(0, readback, 100));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[100], readback, 100);
+}
+
+void test_shadow_damaged_slot_falls_back(void) {
+    // 64-byte pages: entries at 0 and 64, slot A at 128, slot B at 256
+    AT24CXXShadow shadow;
+    TEST_ASSERT_TRUE(shadow.begin(*eeprom, 0, 100));
+    TEST_ASSERT_TRUE(shadow.commit(pattern, 100));
+    TEST_ASSERT_TRUE(shadow.commit(&pattern[100], 80));
+    TEST_ASSERT_TRUE(eeprom->write(256 + 10, (uint8_t)(pattern[110] ^ 1)));
+
+    AT24CXXShadow remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 100));
+    TEST_ASSERT_EQUAL_UINT32(1, remount.generation());
+    TEST_ASSERT_EQUAL_UINT16(100, remount.length());
+    TEST_ASSERT_TRUE(remount.read(0, readback, 100));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 100);
+}
+
+void test_shadow_torn_entry_ignored(void) {
+    AT24CXXShadow shadow;
+    TEST_ASSERT_TRUE(shadow.begin(*eeprom, 0, 100));
+    TEST_ASSERT_TRUE(shadow.commit(pattern, 100));
+    TEST_ASSERT_TRUE(shadow.commit(&pattern[100], 80));
+    // Generation 3 for slot A, cut off before the rest of its entry
+    const uint8_t torn[4] = { 3, 0, 0, 0 };
+    TEST_ASSERT_TRUE(eeprom->write(0, torn, sizeof(torn)));
+
+    AT24CXXShadow remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 0, 100));
+    TEST_ASSERT_EQUAL_UINT32(2, remount.generation());
+    TEST_ASSERT_TRUE(remount.read(0, readback, 80));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[100], readback, 80);
+}
+
+void test_shadow_entries_on_own_pages(void) {
+    // 8-byte pages: each 11-byte entry takes two pages of its own
+    attach(AT24C02);
+    AT24CXXShadow shadow;
+    TEST_ASSERT_TRUE(shadow.begin(*eeprom, 3, 20));
+    TEST_ASSERT_EQUAL_UINT32(2 * 16 + 2 * 24, shadow.regionSize());
+    TEST_ASSERT_TRUE(shadow.commit(pattern, 20));
+    TEST_ASSERT_TRUE(shadow.commit(&pattern[20], 20));
+    // Header from 8: entry A in 8-23, entry B in 24-39, slot A from 40
+    TEST_ASSERT_EQUAL_HEX8(1, sim->peek(8));
+    TEST_ASSERT_EQUAL_HEX8(2, sim->peek(24));
+    for (uint8_t i = 11; i < 16; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(8 + i));
+        TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(24 + i));
+    }
+    TEST_ASSERT_EQUAL_HEX8(pattern[0], sim->peek(40));
+
+    AT24CXXShadow remount;
+    TEST_ASSERT_TRUE(remount.begin(*eeprom, 3, 20));
+    TEST_ASSERT_EQUAL_UINT32(2, remount.generation());
+    TEST_ASSERT_TRUE(remount.read(0, readback, 20));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[20], readback, 20);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_shadow_commit_survives_remount);
+    RUN_TEST(test_shadow_failed_commit_keeps_previous);
+    RUN_TEST(test_shadow_damaged_slot_falls_back);
+    RUN_TEST(test_shadow_torn_entry_ignored);
+    RUN_TEST(test_shadow_entries_on_own_pages);
+    return UNITY_END();
+}
@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Compile-Time Controller Tests
+// Description :
+//               These tests drive AT24CXXStatic with its default bus
+//               policy, AT24CXXWireBus, against the host simulator of
+//               at24cxx_sim.h. They cover page writes with the fixed delay
+//               and with ACK polling, the polling timeout fallback, and
+//               reads split at the block boundaries of the AT24C16.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx_static.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx_static.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+const uint32_t CYCLE_US = (uint32_t)EEPROM_WRITE_CYCLE_TIME_MS * 1000;
+
+uint8_t pattern[512];
+uint8_t readback[512];
+AT24CXXSim* sim = nullptr;
+AT24CXXStatic<AT24C256>* eeprom = nullptr;
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 5 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXXStatic<AT24C256>();
+    eeprom->begin(0, Wire, WP_PIN);
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_static_write_reads_back(void) {
+    TEST_ASSERT_TRUE(eeprom->isConnected());
+    uint64_t start = simClockNs();
+    TEST_ASSERT_TRUE(eeprom->write(30, pattern, 200));
+    // 64-byte pages: 30-63, 64-127, 128-191, 192-229, each given the
+    // fixed delay
+    TEST_ASSERT_EQUAL_UINT32(4, sim->writeCycles());
+    TEST_ASSERT_GREATER_OR_EQUAL(4ULL * CYCLE_US * 1000,
+                                 simClockNs() - start);
+    TEST_ASSERT_TRUE(eeprom->read(30, readback, 200));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 200);
+    TEST_ASSERT_EQUAL_HEX8(pattern[199], eeprom->read(229));
+}
+
+void test_static_polling_faster_than_fixed_delay(void) {
+    eeprom->setAckPolling();
+    uint64_t start = simClockNs();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 256));
+    TEST_ASSERT_LESS_THAN(4ULL * CYCLE_US * 1000, simClockNs() - start);
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 256));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 256);
+}
+
+void test_static_poll_timeout_falls_back(void) {
+    // Busy past the 1 ms polling timeout, done within the fixed delay
+    sim->setWriteCycle(3000, 3000);
+    eeprom->setAckPolling(1000);
+    uint64_t start = simClockNs();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 64));
+    TEST_ASSERT_GREATER_OR_EQUAL((uint64_t)CYCLE_US * 1000,
+                                 simClockNs() - start);
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 64));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 64);
+}
+
+void test_static_poll_timeout_fails_when_still_busy(void) {
+    sim->setWriteCycle(8000, 8000);
+    eeprom->setAckPolling(1000);
+    TEST_ASSERT_FALSE(eeprom->write(0, pattern, 128));
+    // The first page was accepted, the second never sent
+    TEST_ASSERT_EQUAL_UINT32(1, sim->writeCycles());
+    simClockAdvance(5000000);
+    sim->setWriteCycle(1500, 3000);
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 128));
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 128));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 128);
+}
+
+void test_static_empty_read_skips_bus(void) {
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(100, readback, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, Wire.transactions());
+}
+
+void test_static_rejects_out_of_range_and_protected(void) {
+    TEST_ASSERT_FALSE(eeprom->write(32760, pattern, 9));
+    TEST_ASSERT_FALSE(eeprom->read(32760, readback, 9));
+    eeprom->setWriteProtect();
+    TEST_ASSERT_FALSE(eeprom->write(0, pattern, 16));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(0));
+    eeprom->clearWriteProtect();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 16));
+    TEST_ASSERT_EQUAL_HEX8(pattern[0], sim->peek(0));
+}
+
+void test_static_reads_across_blocks(void) {
+    AT24CXXSim small_sim(AT24C16, 0, Wire);
+    AT24CXXStatic<AT24C16> small;
+    small.begin();
+    small.setAckPolling();
+    // 0x1F0-0x30F spans the ends of blocks 1 and 2
+    TEST_ASSERT_TRUE(small.write(0x1F0, pattern, 288));
+    for (uint16_t i = 0; i < 288; i++)
+        TEST_ASSERT_EQUAL_HEX8(pattern[i], small_sim.peek(0x1F0 + i));
+    TEST_ASSERT_TRUE(small.read(0x1F0, readback, 288));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 288);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_static_write_reads_back);
+    RUN_TEST(test_static_polling_faster_than_fixed_delay);
+    RUN_TEST(test_static_poll_timeout_falls_back);
+    RUN_TEST(test_static_poll_timeout_fails_when_still_busy);
+    RUN_TEST(test_static_empty_read_skips_bus);
+    RUN_TEST(test_static_rejects_out_of_range_and_protected);
+    RUN_TEST(test_static_reads_across_blocks);
+    return UNITY_END();
+}
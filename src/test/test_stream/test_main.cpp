@@ -0,0 +1,174 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Sequential Stream Tests
+// Description :
+//               These tests drive AT24CXXStream against the host simulator
+//               of at24cxx_sim.h. Spans are chosen to cross both page
+//               boundaries and the stream's BUFFER_SIZE chunks, and the
+//               simulated chip's contents and write cycles show when
+//               buffered bytes reach the chip.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h,
+//                                    at24cxx_stream.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+#include "at24cxx_stream.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint16_t SPAN = 3 * AT24CXXStream::BUFFER_SIZE + 17;
+
+uint8_t pattern[SPAN];
+uint8_t readback[SPAN];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 11 + (i >> 8));
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire);
+    eeprom->setAckPolling();
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_stream_reads_across_pages_and_chunks(void) {
+    TEST_ASSERT_TRUE(eeprom->write(30, pattern, SPAN));
+    AT24CXXStream stream(*eeprom, 30, 30 + SPAN);
+    TEST_ASSERT_EQUAL_UINT32(SPAN, stream.available());
+    Wire.resetStats();
+    for (uint16_t i = 0; i < SPAN; i++)
+        TEST_ASSERT_EQUAL_INT(pattern[i], stream.read());
+    TEST_ASSERT_EQUAL_INT(-1, stream.read());
+    TEST_ASSERT_EQUAL_INT(-1, stream.peek());
+    TEST_ASSERT_FALSE(stream.failed());
+    // One addressed read per chunk rather than one per byte
+    TEST_ASSERT_EQUAL_UINT32(2 * 4, Wire.transactions());
+}
+
+void test_stream_reads_records(void) {
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, SPAN));
+    AT24CXXStream stream(*eeprom, 0, SPAN);
+    uint16_t done = 0;
+    // Records of 7 bytes straddle chunk ends
+    while (stream.read(&readback[done], 7))
+        done += 7;
+    TEST_ASSERT_EQUAL_UINT16(SPAN - SPAN % 7, done);
+    TEST_ASSERT_EQUAL_UINT32(SPAN % 7, stream.available());
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, done);
+}
+
+void test_stream_range_for(void) {
+    TEST_ASSERT_TRUE(eeprom->write(100, pattern, 300));
+    uint16_t i = 0;
+    for (uint8_t b : AT24CXXStream(*eeprom, 100, 400))
+        readback[i++] = b;
+    TEST_ASSERT_EQUAL_UINT16(300, i);
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 300);
+}
+
+void test_stream_buffers_writes_until_flush(void) {
+    AT24CXXStream stream(*eeprom, 50, 50 + SPAN);
+    for (uint8_t i = 0; i < 20; i++)
+        TEST_ASSERT_EQUAL_UINT32(1, stream.write(pattern[i]));
+    TEST_ASSERT_EQUAL_UINT32(0, sim->writeCycles());
+    TEST_ASSERT_EQUAL_HEX8(0xFF, sim->peek(50));
+    TEST_ASSERT_TRUE(stream.flush());
+    // 50-63 and 64-69 fall in two 64-byte pages
+    TEST_ASSERT_EQUAL_UINT32(2, sim->writeCycles());
+    TEST_ASSERT_EQUAL_UINT32(70, stream.position());
+    TEST_ASSERT_TRUE(eeprom->read(50, readback, 20));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 20);
+}
+
+void test_stream_writes_across_chunks(void) {
+    {
+        AT24CXXStream stream(*eeprom, 30, 30 + SPAN);
+        TEST_ASSERT_TRUE(stream.write(pattern, 10));
+        TEST_ASSERT_TRUE(stream.write(&pattern[10], SPAN - 10));
+        TEST_ASSERT_EQUAL_UINT32(0, stream.available());
+        TEST_ASSERT_FALSE(stream.write(pattern, 1));
+        TEST_ASSERT_EQUAL_UINT32(0, stream.write(pattern[0]));
+        // Remaining bytes are written when the stream goes out of scope
+    }
+    TEST_ASSERT_TRUE(eeprom->read(30, readback, SPAN));
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, SPAN);
+}
+
+void test_stream_read_after_write(void) {
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 64));
+    AT24CXXStream stream(*eeprom, 0, 64);
+    TEST_ASSERT_EQUAL_INT(pattern[0], stream.read());
+    // Bytes fetched ahead are replaced by the write
+    TEST_ASSERT_EQUAL_UINT32(1, stream.write((uint8_t)0xA5));
+    TEST_ASSERT_EQUAL_INT(pattern[2], stream.read());
+    TEST_ASSERT_EQUAL_HEX8(0xA5, sim->peek(1));
+    TEST_ASSERT_TRUE(stream.seek(1));
+    TEST_ASSERT_EQUAL_INT(0xA5, stream.read());
+}
+
+void test_stream_seek(void) {
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, SPAN));
+    AT24CXXStream stream(*eeprom, 0, SPAN);
+    TEST_ASSERT_EQUAL_INT(pattern[0], stream.read());
+    // Forward within the fetched chunk costs no bus transfer
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(stream.seek(40));
+    TEST_ASSERT_EQUAL_INT(pattern[40], stream.read());
+    TEST_ASSERT_EQUAL_UINT32(0, Wire.transactions());
+    // Backward and past the chunk read from the chip again
+    TEST_ASSERT_TRUE(stream.seek(5));
+    TEST_ASSERT_EQUAL_INT(pattern[5], stream.peek());
+    TEST_ASSERT_TRUE(stream.seek(SPAN - 3));
+    TEST_ASSERT_TRUE(stream.read(readback, 3));
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[SPAN - 3], readback, 3);
+    TEST_ASSERT_EQUAL_UINT32(SPAN, stream.position());
+    TEST_ASSERT_TRUE(stream.seek(SPAN));
+    TEST_ASSERT_FALSE(stream.seek(SPAN + 1));
+    TEST_ASSERT_EQUAL_UINT32(SPAN, stream.position());
+}
+
+void test_stream_failed_read(void) {
+    Wire.detach(sim);
+    AT24CXXStream stream(*eeprom, 0, 100);
+    TEST_ASSERT_EQUAL_INT(-1, stream.read());
+    TEST_ASSERT_TRUE(stream.failed());
+    TEST_ASSERT_EQUAL_UINT32(0, stream.available());
+    TEST_ASSERT_FALSE(stream.flush());
+    Wire.attach(sim);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_stream_reads_across_pages_and_chunks);
+    RUN_TEST(test_stream_reads_records);
+    RUN_TEST(test_stream_range_for);
+    RUN_TEST(test_stream_buffers_writes_until_flush);
+    RUN_TEST(test_stream_writes_across_chunks);
+    RUN_TEST(test_stream_read_after_write);
+    RUN_TEST(test_stream_seek);
+    RUN_TEST(test_stream_failed_read);
+    return UNITY_END();
+}
@@ -0,0 +1,146 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Telemetry Tests
+// Description :
+//               These tests drive AT24CXX with setTelemetry() against the
+//               host simulator of at24cxx_sim.h. Counters are compared with
+//               the transfers each call must make, and latencies with the
+//               histogram bucket their simulated duration falls in.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+const uint8_t WP_PIN = 7;
+
+uint8_t pattern[128];
+uint8_t readback[128];
+AT24CXXStats stats;
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+// Sum of histogram buckets
+uint32_t total(const uint32_t* histogram) {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < AT24CXX_LATENCY_BUCKETS; i++)
+        sum += histogram[i];
+    return sum;
+}
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 3);
+    memset(readback, 0, sizeof(readback));
+    memset(&stats, 0, sizeof(stats));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    sim->setWriteProtectPin(WP_PIN);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire, WP_PIN);
+    eeprom->setTelemetry(&stats);
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_telemetry_counts_transfers(void) {
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 100));
+    // 64-byte pages: 0-63 and 64-99
+    TEST_ASSERT_EQUAL_UINT32(2, stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.write_cycles);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.bytes_written);
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 100));
+    // Address phase and one data phase
+    TEST_ASSERT_EQUAL_UINT32(4, stats.transactions);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.bytes_read);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.nacks);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.ack_polls);
+}
+
+void test_telemetry_counts_nacks_and_polls(void) {
+    eeprom->setAckPolling();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 16));
+    // The chip NACKs polls while busy, then acknowledges the last
+    TEST_ASSERT_GREATER_THAN(1, stats.ack_polls);
+    TEST_ASSERT_EQUAL_UINT32(stats.ack_polls - 1, stats.nacks);
+    TEST_ASSERT_EQUAL_UINT32(1 + stats.ack_polls, stats.transactions);
+    memset(&stats, 0, sizeof(stats));
+    eeprom->setWriteProtect();
+    TEST_ASSERT_FALSE(eeprom->write(0, pattern, 16));
+    eeprom->clearWriteProtect();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.nacks);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.write_cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.bytes_written);
+}
+
+void test_telemetry_latency_buckets(void) {
+    // One page and the fixed 5 ms delay: 4096 us to 8192 us, bucket 7
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 32));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.write_latency[7]);
+    TEST_ASSERT_EQUAL_UINT32(1, total(stats.write_latency));
+    TEST_ASSERT_GREATER_OR_EQUAL(5000, stats.blocked_us);
+    uint64_t blocked = stats.blocked_us;
+    // A one byte read at 400 kHz takes 64 us to 128 us, bucket 1
+    eeprom->read(0);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.read_latency[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, total(stats.read_latency));
+    TEST_ASSERT_GREATER_THAN(blocked, stats.blocked_us);
+    // Two pages take longer than 8192 us, bucket 8
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 128));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.write_latency[8]);
+    TEST_ASSERT_EQUAL_UINT32(2, total(stats.write_latency));
+}
+
+void test_telemetry_cleared_and_reset(void) {
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 16));
+    eeprom->clearTelemetry();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 16));
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 16));
+    // Counts stay in the caller's struct, and no more are added
+    TEST_ASSERT_EQUAL_UINT32(1, stats.write_cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.bytes_read);
+    eeprom->setTelemetry(&stats);
+    eeprom->resetTelemetry();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.write_cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, total(stats.write_latency));
+}
+
+void test_telemetry_shared_between_instances(void) {
+    AT24CXXSim other_sim(AT24C256, 1, Wire);
+    AT24CXX other;
+    other.begin(AT24C256, 1, Wire);
+    other.setTelemetry(&stats);
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 16));
+    TEST_ASSERT_TRUE(other.write(0, pattern, 16));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.write_cycles);
+    TEST_ASSERT_EQUAL_UINT32(2, total(stats.write_latency));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_telemetry_counts_transfers);
+    RUN_TEST(test_telemetry_counts_nacks_and_polls);
+    RUN_TEST(test_telemetry_latency_buckets);
+    RUN_TEST(test_telemetry_cleared_and_reset);
+    RUN_TEST(test_telemetry_shared_between_instances);
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Address Tracking Tests
+// Description :
+//               These tests drive AT24CXX with setAddressTracking() against
+//               the host simulator of at24cxx_sim.h. A read with a word
+//               address phase costs two bus transactions and a current
+//               address read costs one, so the simulated bus's transaction
+//               count shows which form each read took.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+uint8_t pattern[256];
+uint8_t readback[256];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < sizeof(pattern); i++)
+        pattern[i] = (uint8_t)(i * 7 + 3);
+    memset(readback, 0, sizeof(readback));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C256, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C256, 0, Wire);
+    eeprom->setAckPolling();
+    TEST_ASSERT_TRUE(eeprom->write(0, pattern, 64));
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_address_tracking_skips_address_phase(void) {
+    // Off by default: each read has an address phase and a data phase
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 16));
+    TEST_ASSERT_TRUE(eeprom->read(16, &readback[16], 16));
+    TEST_ASSERT_EQUAL_UINT32(4, Wire.transactions());
+    // On: reads continuing from the last are only a data phase
+    eeprom->setAddressTracking();
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(32, &readback[32], 16));
+    TEST_ASSERT_TRUE(eeprom->read(48, &readback[48], 16));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 64);
+}
+
+void test_address_tracking_addresses_other_reads(void) {
+    eeprom->setAddressTracking();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 8));
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(32, readback, 8));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[32], readback, 8);
+    eeprom->clearAddressTracking();
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(40, readback, 8));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+}
+
+void test_address_tracking_invalidated_by_write(void) {
+    eeprom->setAddressTracking();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 4));
+    TEST_ASSERT_TRUE(eeprom->write(4, (uint8_t)0x5A));
+    TEST_ASSERT_EQUAL_HEX8(0x5A, eeprom->read(4));
+    TEST_ASSERT_EQUAL_HEX8(pattern[5], eeprom->read(5));
+}
+
+void test_address_tracking_rolls_over(void) {
+    TEST_ASSERT_TRUE(eeprom->write(32760, pattern, 8));
+    eeprom->setAddressTracking();
+    TEST_ASSERT_TRUE(eeprom->read(32760, readback, 8));
+    // The chip's counter wraps to the start of memory
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 8));
+    TEST_ASSERT_EQUAL_UINT32(1, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(pattern, readback, 8);
+}
+
+void test_address_tracking_after_failed_read(void) {
+    eeprom->setAddressTracking();
+    TEST_ASSERT_TRUE(eeprom->read(0, readback, 8));
+    // Detach the chip so the next read fails, then restore it
+    Wire.detach(sim);
+    TEST_ASSERT_FALSE(eeprom->read(8, readback, 8));
+    Wire.attach(sim);
+    Wire.resetStats();
+    TEST_ASSERT_TRUE(eeprom->read(8, readback, 8));
+    TEST_ASSERT_EQUAL_UINT32(2, Wire.transactions());
+    TEST_ASSERT_EQUAL_MEMORY(&pattern[8], readback, 8);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_address_tracking_skips_address_phase);
+    RUN_TEST(test_address_tracking_addresses_other_reads);
+    RUN_TEST(test_address_tracking_invalidated_by_write);
+    RUN_TEST(test_address_tracking_rolls_over);
+    RUN_TEST(test_address_tracking_after_failed_read);
+    return UNITY_END();
+}
@@ -0,0 +1,163 @@
+//----------------------------------------------------------------------------
+// Name        : test_main.cpp
+// Purpose     : AT24CXX EEPROM Wear Tracking Tests
+// Description :
+//               These tests drive AT24CXX with setWearTracking() against
+//               the host simulator of at24cxx_sim.h. Page counts are
+//               checked against the writes made, and saving the counts
+//               from service() against the simulated chip's write cycles
+//               as the simulated clock is advanced past the interval.
+//
+// Platform    : Host (Linux, macOS)
+// Language    : C++
+// Framework   : Unity
+// Copyright   : MIT License 2022, John Greenwell
+// Requires    : External Libraries : N/A
+//               Custom Libraries   : at24cxx.h, at24cxx_sim.h
+//----------------------------------------------------------------------------
+
+#include <string.h>
+#include <unity.h>
+#include "at24cxx_sim.h"
+#include "at24cxx.h"
+
+using namespace PeripheralIO;
+
+namespace {
+
+// AT24C64: 256 pages of 32 bytes
+const uint16_t N_PAGES = 256;
+const uint16_t REGION = 0x1800;
+const uint32_t INTERVAL_MS = 1000;
+
+uint32_t counts[N_PAGES];
+AT24CXXSim* sim = nullptr;
+AT24CXX* eeprom = nullptr;
+
+// Advance the simulated clock by ms
+void advanceMs(uint32_t ms) {
+    simClockAdvance((uint64_t)ms * 1000000);
+}
+
+}
+
+void setUp(void) {
+    memset(counts, 0, sizeof(counts));
+    Wire.setClock(400000);
+    sim = new AT24CXXSim(AT24C64, 0, Wire);
+    eeprom = new AT24CXX();
+    eeprom->begin(AT24C64, 0, Wire);
+    eeprom->setAckPolling();
+    TEST_ASSERT_TRUE(eeprom->setWearTracking(counts, N_PAGES));
+}
+
+void tearDown(void) {
+    delete eeprom;
+    delete sim;
+    eeprom = nullptr;
+    sim = nullptr;
+}
+
+void test_wear_counts_page_writes(void) {
+    uint8_t data[40] = { 0 };
+    TEST_ASSERT_TRUE(eeprom->write(100, data, sizeof(data)));
+    // 100-127 and 128-139 lie in pages 3 and 4
+    TEST_ASSERT_EQUAL_UINT32(1, eeprom->pageWrites(3));
+    TEST_ASSERT_EQUAL_UINT32(1, eeprom->pageWrites(4));
+    TEST_ASSERT_EQUAL_UINT32(0, eeprom->pageWrites(5));
+    TEST_ASSERT_EQUAL_UINT32(0, eeprom->pageWrites(N_PAGES));
+    TEST_ASSERT_FALSE(eeprom->setWearTracking(counts, N_PAGES - 1));
+}
+
+void test_wear_hottest_pages_and_remaining_life(void) {
+    for (uint8_t i = 0; i < 3; i++)
+        TEST_ASSERT_TRUE(eeprom->write(3 * 32, i));
+    for (uint8_t i = 0; i < 5; i++)
+        TEST_ASSERT_TRUE(eeprom->write(200 * 32, i));
+    TEST_ASSERT_TRUE(eeprom->write(7 * 32, (uint8_t)1));
+    uint16_t pages[4];
+    TEST_ASSERT_EQUAL_UINT16(4, eeprom->hottestPages(pages, 4));
+    TEST_ASSERT_EQUAL_UINT16(200, pages[0]);
+    TEST_ASSERT_EQUAL_UINT16(3, pages[1]);
+    TEST_ASSERT_EQUAL_UINT16(7, pages[2]);
+    TEST_ASSERT_EQUAL_UINT32(0, counts[pages[3]]);
+    TEST_ASSERT_EQUAL_UINT32(AT24CXX_ENDURANCE - 5, eeprom->remainingLife());
+    TEST_ASSERT_EQUAL_UINT32(5, eeprom->remainingLife(10));
+    TEST_ASSERT_EQUAL_UINT32(0, eeprom->remainingLife(4));
+}
+
+void test_wear_saved_and_loaded(void) {
+    TEST_ASSERT_TRUE(eeprom->write(5 * 32, (uint8_t)1));
+    TEST_ASSERT_TRUE(eeprom->write(5 * 32, (uint8_t)2));
+    TEST_ASSERT_TRUE(eeprom->saveWear(REGION));
+    // A fresh instance over the same chip restores the counts
+    uint32_t restored[N_PAGES] = { 0 };
+    AT24CXX other;
+    other.begin(AT24C64, 0, Wire);
+    other.setAckPolling();
+    TEST_ASSERT_TRUE(other.setWearTracking(restored, N_PAGES));
+    TEST_ASSERT_TRUE(other.loadWear(REGION));
+    TEST_ASSERT_EQUAL_UINT32(2, other.pageWrites(5));
+    TEST_ASSERT_EQUAL_UINT32(0, other.pageWrites(6));
+}
+
+void test_wear_load_rejects_other_data(void) {
+    TEST_ASSERT_TRUE(eeprom->write(REGION + 0x100, (uint8_t)1));
+    // Erased memory, and counts saved for a chip of another page count
+    TEST_ASSERT_FALSE(eeprom->loadWear(REGION));
+    uint32_t small_counts[128] = { 0 };
+    AT24CXX small;
+    small.begin(AT24C32, 0, Wire);
+    small.setAckPolling();
+    TEST_ASSERT_TRUE(small.setWearTracking(small_counts, 128));
+    TEST_ASSERT_TRUE(small.saveWear(0));
+    TEST_ASSERT_FALSE(eeprom->loadWear(0));
+    // Counts are left as they were
+    TEST_ASSERT_EQUAL_UINT32(1, eeprom->pageWrites((REGION + 0x100) / 32));
+}
+
+void test_wear_save_throttled(void) {
+    eeprom->setWearPersistence(REGION, INTERVAL_MS);
+    // The header and the counts behind it span 33 pages, the first
+    // written twice
+    const uint32_t region_pages = 34;
+    TEST_ASSERT_TRUE(eeprom->write(0, (uint8_t)1));
+    uint32_t cycles = sim->writeCycles();
+    // Not saved before the interval has passed
+    eeprom->service();
+    TEST_ASSERT_EQUAL_UINT32(cycles, sim->writeCycles());
+    advanceMs(INTERVAL_MS);
+    eeprom->service();
+    TEST_ASSERT_EQUAL_UINT32(cycles + region_pages, sim->writeCycles());
+    // A further write waits for the next interval
+    TEST_ASSERT_TRUE(eeprom->write(0, (uint8_t)2));
+    cycles = sim->writeCycles();
+    for (uint8_t i = 0; i < 10; i++)
+        eeprom->service();
+    advanceMs(INTERVAL_MS / 2);
+    eeprom->service();
+    TEST_ASSERT_EQUAL_UINT32(cycles, sim->writeCycles());
+    advanceMs(INTERVAL_MS / 2);
+    eeprom->service();
+    TEST_ASSERT_EQUAL_UINT32(cycles + region_pages, sim->writeCycles());
+    // Saving wears only the region, so unchanged counts are not saved
+    advanceMs(INTERVAL_MS);
+    eeprom->service();
+    TEST_ASSERT_EQUAL_UINT32(cycles + region_pages, sim->writeCycles());
+    uint32_t restored[N_PAGES] = { 0 };
+    AT24CXX other;
+    other.begin(AT24C64, 0, Wire);
+    TEST_ASSERT_TRUE(other.setWearTracking(restored, N_PAGES));
+    TEST_ASSERT_TRUE(other.loadWear(REGION));
+    TEST_ASSERT_EQUAL_UINT32(2, other.pageWrites(0));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_wear_counts_page_writes);
+    RUN_TEST(test_wear_hottest_pages_and_remaining_life);
+    RUN_TEST(test_wear_saved_and_loaded);
+    RUN_TEST(test_wear_load_rejects_other_data);
+    RUN_TEST(test_wear_save_throttled);
+    return UNITY_END();
+}